@@ -1,56 +1,64 @@
 #include "Animal.h"
-#include "Game.h"
+#include "World.h"
 
 
 const std::vector<Animal::Type> Animal::listAnimalTypes = {
-	{ "Animal 1", 0.5f },
-	{ "Animal 2", 0.6f },
-	{ "Animal 3", 0.95f }
+	{ "Animal 1", 0.5f, { 240, 240, 230, 255 } },
+	{ "Animal 2", 0.6f, { 150, 100, 60, 255 } },
+	{ "Animal 3", 0.95f, { 70, 70, 80, 255 } }
 };
+std::vector<Animal::TypeSprites> Animal::listTypeSprites;
 
+const float Animal::speed = 1.5f;
+const float Animal::speedAngular = MathAddon::angleDegToRad(180.0f);
 
+RotatedSpriteCache Animal::rotatedSpriteCache;
 
 
-Animal::Animal(SDL_Renderer* renderer, int setTypeID, Vector2D setPos, float setAngle) :
-	stateCurrent(State::idle), typeID(setTypeID), pos(setPos), angle(setAngle), timerStateIdle(1.0f),
-	timerGrowth(7.5f + MathAddon::randFloat() * 7.5f) {
 
-	if (setTypeID > -1 && setTypeID < listAnimalTypes.size()) {
-		std::string name = listAnimalTypes[setTypeID].name;
-		textureSmallMain = TextureLoader::loadTexture(renderer, name + " Small.bmp");
-		textureSmallShadow = TextureLoader::loadTexture(renderer, name + " Small Shadow.bmp");
-		textureMain = TextureLoader::loadTexture(renderer, name + ".bmp");
-		textureShadow = TextureLoader::loadTexture(renderer, name + " Shadow.bmp");
-	}
+
+int Animal::add(AnimalStore& animals, int animalTypeID, Vector2D pos, float angle) {
+	//Add an animal of the input type and return it's index, or -1 if the type doesn't exist.
+	if (animalTypeID > -1 && animalTypeID < listAnimalTypes.size())
+		return animals.add((Uint8)animalTypeID, pos, angle, Timer(1.0f),
+			Timer(7.5f + MathAddon::randFloat() * 7.5f));
+
+	return -1;
 }
 
 
 
-void Animal::update(float dT, Game& game) {
-	//Grow animal if needed.
-	timerGrowth.countUp(dT);
+void Animal::update(AnimalStore& animals, int index, float dT, World& world) {
+	//Store the previous position and angle so that they can be interpolated between ticks.
+	animals.listPosPrevious[index] = animals.listPos[index];
+	animals.listAnglePrevious[index] = animals.listAngle[index];
+
+	//Grow the animal if needed.
+	animals.listTimerGrowth[index].countUp(dT);
 
 
-	//Update this animal based on it's current state.
+	//Update the animal based on it's current state.
+	State& stateCurrent = animals.listState[index];
 	switch (stateCurrent) {
 	case State::idle:
-		updateStateIdle(dT, game);
+		updateStateIdle(animals, index, dT, world);
 		break;
 	case State::moving:
 		//Note: Bitwise and is used on purpose here so that both functions are called.
-		if (updateMove(dT) & updateAngle(dT))
+		if (updateMove(animals, index, dT) & updateAngle(animals, index, dT))
 			stateCurrent = State::idle;
 		break;
 	case State::rotating:
-		if (updateAngle(dT))
+		if (updateAngle(animals, index, dT))
 			stateCurrent = State::idle;
 		break;
 	}
 }
 
 
-void Animal::updateStateIdle(float dT, Game& game) {
+void Animal::updateStateIdle(AnimalStore& animals, int index, float dT, World& world) {
 	//Periodically check if a new target point to move to is needed.
+	Timer& timerStateIdle = animals.listTimerStateIdle[index];
 	timerStateIdle.countUp(dT);
 	if (timerStateIdle.timeSIsMax()) {
 		timerStateIdle.resetToZero();
@@ -59,16 +67,17 @@ void Animal::updateStateIdle(float dT, Game& game) {
 		const float probMove = 0.1f, probRotate = 0.2f;
 
 		if (probRandom < probMove)
-			moveToRandomPosition(game);
+			moveToRandomPosition(animals, index, world);
 		else if (probRandom < (probMove + probRotate))
-			rotateToRandomAngle();
+			rotateToRandomAngle(animals, index);
 	}
 }
 
 
-bool Animal::updateMove(float dT) {
-	//Move this towards the target point.
+bool Animal::updateMove(AnimalStore& animals, int index, float dT) {
+	//Move the animal towards the target point.
 	bool reachedPosTarget = false;
+	float& distanceToTarget = animals.listDistanceToTarget[index];
 
 	//Determine the distance to move this frame.
 	float distanceMove = speed * dT;
@@ -77,16 +86,18 @@ bool Animal::updateMove(float dT) {
 		reachedPosTarget = true;
 	}
 
-	pos += (directionNormalTarget * distanceMove);
+	animals.listPos[index] += (animals.listDirectionNormalTarget[index] * distanceMove);
 	distanceToTarget -= distanceMove;
 
 	return reachedPosTarget;
 }
 
 
-bool Animal::updateAngle(float dT) {
-	//Rotate this towards the target point.
+bool Animal::updateAngle(AnimalStore& animals, int index, float dT) {
+	//Rotate the animal towards the target point.
 	bool reachedAngleTarget = false;
+	float& angle = animals.listAngle[index];
+	Vector2D& directionNormalTarget = animals.listDirectionNormalTarget[index];
 
 	//Determine the angle to the target.
 	float angleToTarget = Vector2D(angle).angleBetween(directionNormalTarget);
@@ -110,105 +121,152 @@ bool Animal::updateAngle(float dT) {
 
 
 
-void Animal::moveToRandomPosition(Game& game) {
+void Animal::moveToRandomPosition(AnimalStore& animals, int index, World& world) {
 	for (int count = 0; count < 10; count++) {
 		Vector2D normal = Vector2D(MathAddon::randAngleRad());
 		float distance = MathAddon::randFloat() * 1.0f + 0.5f;
 
-		Vector2D posCheck = pos + (normal * distance);
-		if (checkIfPositionOK(posCheck, game)) {
-			directionNormalTarget = normal;
-			distanceToTarget = distance;
-			stateCurrent = State::moving;
+		Vector2D posCheck = animals.listPos[index] + (normal * distance);
+		if (checkIfPositionOkGeneral(posCheck, animals.listTypeID[index], index, world)) {
+			animals.listDirectionNormalTarget[index] = normal;
+			animals.listDistanceToTarget[index] = distance;
+			animals.listState[index] = State::moving;
 			return;
 		}
 	}
 }
 
 
-void Animal::rotateToRandomAngle() {
-	directionNormalTarget = Vector2D(MathAddon::randAngleRad());
-	distanceToTarget = 0.0f;
-	stateCurrent = State::rotating;
+void Animal::rotateToRandomAngle(AnimalStore& animals, int index) {
+	animals.listDirectionNormalTarget[index] = Vector2D(MathAddon::randAngleRad());
+	animals.listDistanceToTarget[index] = 0.0f;
+	animals.listState[index] = State::rotating;
 }
 
 
 
-void Animal::draw(SDL_Renderer* renderer, int tileSize) {
-	if (timerGrowth.timeSIsMax())
-		//Fully grown.
-		drawTextureWithOffset(renderer, textureMain, tileSize, 0);
-	else
-		//Still growing.
-		drawTextureWithOffset(renderer, textureSmallMain, tileSize, 0);
+void Animal::registerSpriteAssets() {
+	//Resolve each type's images to asset ids once, so that drawing only has to index arrays.
+	if (listTypeSprites.empty()) {
+		for (const auto& typeSelected : listAnimalTypes) {
+			TypeSprites typeSpritesAdded;
+			typeSpritesAdded.assetIDSmallMain = TextureLoader::registerAsset(typeSelected.name + " Small.bmp");
+			typeSpritesAdded.assetIDSmallShadow = TextureLoader::registerAsset(typeSelected.name + " Small Shadow.bmp");
+			typeSpritesAdded.assetIDMain = TextureLoader::registerAsset(typeSelected.name + ".bmp");
+			typeSpritesAdded.assetIDShadow = TextureLoader::registerAsset(typeSelected.name + " Shadow.bmp");
+			listTypeSprites.push_back(typeSpritesAdded);
+		}
+	}
 }
 
 
-void Animal::drawShadow(SDL_Renderer* renderer, int tileSize) {
-	if (timerGrowth.timeSIsMax())
+const Animal::TypeSprites& Animal::loadSprites(SDL_Renderer* renderer, int animalTypeID) {
+	//The sprites are only needed for drawing so load them the first time the type is drawn.  They
+	//decode in the background and draw as placeholders until then, so keep asking until each one
+	//has either loaded or failed.
+	registerSpriteAssets();
+	TypeSprites& sprites = listTypeSprites[animalTypeID];
+	if (sprites.main.checkIfResolved() == false || sprites.smallMain.checkIfResolved() == false ||
+		sprites.shadow.checkIfResolved() == false || sprites.smallShadow.checkIfResolved() == false) {
+		sprites.smallMain = TextureLoader::requestSprite(renderer, sprites.assetIDSmallMain);
+		sprites.smallShadow = TextureLoader::requestSprite(renderer, sprites.assetIDSmallShadow);
+		sprites.main = TextureLoader::requestSprite(renderer, sprites.assetIDMain);
+		sprites.shadow = TextureLoader::requestSprite(renderer, sprites.assetIDShadow);
+	}
+
+	return sprites;
+}
+
+
+void Animal::draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, AnimalStore& animals, int index,
+	const Camera& camera, float alpha) {
+	const TypeSprites& sprites = loadSprites(renderer, animals.listTypeID[index]);
+	if (animals.listTimerGrowth[index].timeSIsMax())
 		//Fully grown.
-		drawTextureWithOffset(renderer, textureShadow, tileSize, 8);
+		drawSpriteWithOffset(renderer, spriteBatch, animals, index, sprites.main, camera, alpha, 0, 255);
 	else
 		//Still growing.
-		drawTextureWithOffset(renderer, textureSmallShadow, tileSize, 5);
+		drawSpriteWithOffset(renderer, spriteBatch, animals, index, sprites.smallMain, camera, alpha, 0, 255);
 }
 
 
-void Animal::drawTextureWithOffset(SDL_Renderer* renderer, SDL_Texture* textureSelected,
-	int tileSize, int offset) {
-	if (renderer != nullptr && textureSelected != nullptr) {
-		int w, h;
-		SDL_QueryTexture(textureSelected, NULL, NULL, &w, &h);
+void Animal::drawShadow(SDL_Renderer* renderer, SpriteBatch& spriteBatch, AnimalStore& animals, int index,
+	const Camera& camera, float alpha, Uint8 alphaShadow) {
+	//Fully grown or still growing.  A placeholder has no shadow.
+	const TypeSprites& sprites = loadSprites(renderer, animals.listTypeID[index]);
+	bool grown = animals.listTimerGrowth[index].timeSIsMax();
+	const Sprite& spriteSelected = (grown ? sprites.shadow : sprites.smallShadow);
+	if (spriteSelected.isPlaceholder == false)
+		drawSpriteWithOffset(renderer, spriteBatch, animals, index, spriteSelected, camera, alpha,
+			(grown ? sprites.offsetShadow : sprites.offsetSmallShadow), alphaShadow);
+}
 
-		SDL_Rect rect = {
-			(int)round(pos.x * tileSize) - w / 2 - offset,
-			(int)round(pos.y * tileSize) - h / 2 + offset,
-			w,
-			h };
-		SDL_RenderCopyEx(renderer, textureSelected, NULL, &rect,
-			MathAddon::angleRadToDeg(angle), NULL, SDL_FLIP_NONE);
-	}
+
+void Animal::setRotatedSpriteAngleCount(int angleCount) {
+	//Zero turns the cache off so that the sprites are rotated exactly when they're drawn.
+	rotatedSpriteCache.setAngleCount(angleCount);
 }
 
 
+void Animal::refreshRotatedSprites(SDL_Renderer* renderer) {
+	rotatedSpriteCache.refresh(renderer);
+}
 
-bool Animal::checkIfTilesUnderOk(Level& level) {
-	if (typeID > -1 && typeID < listAnimalTypes.size())
-		return level.checkIfPositionOkForAnimal(pos, listAnimalTypes[typeID].radius);
 
-	return false;
+void Animal::drawSpriteWithOffset(SDL_Renderer* renderer, SpriteBatch& spriteBatch, AnimalStore& animals,
+	int index, const Sprite& spriteSelected, const Camera& camera, float alpha, int offset, Uint8 alphaMod) {
+	if (renderer != nullptr && spriteSelected.checkIfLoaded()) {
+		//Interpolate the position and angle between the previous and current ticks.  The angle
+		//takes the shortest way around.
+		Vector2D pos = animals.listPos[index], posPrevious = animals.listPosPrevious[index];
+		float angle = animals.listAngle[index], anglePrevious = animals.listAnglePrevious[index];
+		Vector2D posInterpolated = posPrevious + (pos - posPrevious) * alpha;
+		float angleInterpolated = anglePrevious +
+			(float)remainder(angle - anglePrevious, 2.0f * MathAddon::PI) * alpha;
+
+		//The offset is in pixels when the zoom is one.
+		Vector2D posOffset = Vector2D((float)-offset, (float)offset) / (float)camera.getTileSize();
+		Vector2D posScreen = camera.convertWorldToScreen(posInterpolated + posOffset);
+		rotatedSpriteCache.draw(renderer, spriteBatch, spriteSelected,
+			SDL_Point{ (int)std::round(posScreen.x), (int)std::round(posScreen.y) }, camera.getZoom(),
+			MathAddon::angleRadToDeg(angleInterpolated), alphaMod);
+	}
 }
 
 
-bool Animal::checkIfPositionOkForType(Vector2D posCheck, int animalTypeID, Game& game) {
-	return checkIfPositionOkGeneral(posCheck, animalTypeID, nullptr, game);
+
+bool Animal::checkIfTilesUnderOk(AnimalStore& animals, int index, Level& level) {
+	return level.checkIfPositionOkForAnimal(animals.listPos[index],
+		computeRadius(animals.listTypeID[index]));
 }
 
 
-bool Animal::checkIfPositionOK(Vector2D posCheck, Game& game) {
-	return checkIfPositionOkGeneral(posCheck, typeID, this, game);
+bool Animal::checkIfPositionOkForType(Vector2D posCheck, int animalTypeID, World& world) {
+	return checkIfPositionOkGeneral(posCheck, animalTypeID, -1, world);
 }
 
 
-bool Animal::checkIfPositionOkGeneral(Vector2D posCheck, int animalTypeID, Animal* animalExclude,
-	Game& game) {
+bool Animal::checkIfPositionOkGeneral(Vector2D posCheck, int animalTypeID, int indexExclude,
+	World& world) {
 	//Check if the input position is ok or blocked.
 	if (animalTypeID > -1 && animalTypeID < listAnimalTypes.size()) {
 		float radiusCheck = listAnimalTypes[animalTypeID].radius;
 
 		//Check overlap with the level.
-		if (game.getLevel().checkIfPositionOkForAnimal(posCheck, radiusCheck) == false)
+		if (world.getLevel().checkIfPositionOkForAnimal(posCheck, radiusCheck) == false)
 			return false;
 
 		//Check overlap with animals.
-		for (auto& animalSelected : game.getListAnimals())
-			if ((&animalSelected != animalExclude) &&
-				animalSelected.checkCircleOverlap(posCheck, radiusCheck))
+		AnimalStore& animals = world.getAnimals();
+		for (int animalID : world.queryAnimals(posCheck, radiusCheck))
+			if (animalID != indexExclude &&
+				checkCircleOverlap(animals, animalID, posCheck, radiusCheck))
 				return false;
 
 		//Check overlap with plants.
-		for (auto& plantSelected : game.getListPlants())
-			if (plantSelected.checkCircleOverlap(posCheck, radiusCheck))
+		PlantStore& plants = world.getPlants();
+		for (int plantID : world.queryPlants(posCheck, radiusCheck))
+			if (Plant::checkCircleOverlap(plants, plantID, posCheck, radiusCheck))
 				return false;
 
 		return true;
@@ -219,9 +277,23 @@ bool Animal::checkIfPositionOkGeneral(Vector2D posCheck, int animalTypeID, Anima
 
 
 
-bool Animal::checkCircleOverlap(Vector2D posCircle, float radiusCircle) {
-	if (typeID > -1 && typeID < listAnimalTypes.size())
-		return (pos - posCircle).magnitude() <= (listAnimalTypes[typeID].radius + radiusCircle);
+float Animal::computeRadius(int animalTypeID) {
+	if (animalTypeID > -1 && animalTypeID < listAnimalTypes.size())
+		return listAnimalTypes[animalTypeID].radius;
 
-	return false;
+	return 0.0f;
+}
+
+
+bool Animal::checkCircleOverlap(AnimalStore& animals, int index, Vector2D posCircle, float radiusCircle) {
+	return (animals.listPos[index] - posCircle).magnitude() <=
+		(listAnimalTypes[animals.listTypeID[index]].radius + radiusCircle);
+}
+
+
+SDL_Color Animal::getColorOverview(int animalTypeID) {
+	if (animalTypeID > -1 && animalTypeID < listAnimalTypes.size())
+		return listAnimalTypes[animalTypeID].colorOverview;
+
+	return SDL_Color{ 0, 0, 0, 255 };
 }
\ No newline at end of file
@@ -6,63 +6,75 @@
 #include "Timer.h"
 #include "MathAddon.h"
 #include "Level.h"
-class Game;
+#include "Camera.h"
+#include "AnimalStore.h"
+#include "RotatedSpriteCache.h"
+class World;
 
 
 
+//The rules for how animals behave and are drawn.  The animals themselves are stored in an
+//AnimalStore and identified by their index into it.
 class Animal
 {
 private:
-	enum class State {
-		idle,
-		moving,
-		rotating
-	} stateCurrent;
+	using State = AnimalStore::State;
 
 	
 	struct Type {
 		std::string name = "";
 		float radius = 0.5f;
+		//Used instead of the textures when the camera is zoomed far out.
+		SDL_Color colorOverview = { 0, 0, 0, 255 };
+	};
+
+	//What every animal of a type is drawn with, shared by all of them instead of stored per
+	//animal.  The asset ids are resolved once at startup so that the sprites can be looked up
+	//without building filenames, and the sprites are filled in the first time the type is drawn.
+	struct TypeSprites {
+		int assetIDSmallMain = -1, assetIDSmallShadow = -1, assetIDMain = -1, assetIDShadow = -1;
+		Sprite smallMain, smallShadow, main, shadow;
+		//How far the shadows are drawn from the animal, in pixels when the zoom is one.
+		int offsetShadow = 8, offsetSmallShadow = 5;
 	};
 
 
 public:
-	Animal(SDL_Renderer* renderer, int setTypeID, Vector2D setPos, float setAngle);
-	void update(float dT, Game& game);
-	void draw(SDL_Renderer* renderer, int tileSize);
-	void drawShadow(SDL_Renderer* renderer, int tileSize);
-	bool checkIfTilesUnderOk(Level& level);
-	static bool checkIfPositionOkForType(Vector2D posCheck, int animalTypeID, Game& game);
-	bool checkCircleOverlap(Vector2D posCircle, float radiusCircle);
+	static int add(AnimalStore& animals, int animalTypeID, Vector2D pos, float angle);
+	static void update(AnimalStore& animals, int index, float dT, World& world);
+	static void draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, AnimalStore& animals, int index,
+		const Camera& camera, float alpha);
+	static void drawShadow(SDL_Renderer* renderer, SpriteBatch& spriteBatch, AnimalStore& animals, int index,
+		const Camera& camera, float alpha, Uint8 alphaShadow);
+	static bool checkIfTilesUnderOk(AnimalStore& animals, int index, Level& level);
+	static bool checkIfPositionOkForType(Vector2D posCheck, int animalTypeID, World& world);
+	static bool checkCircleOverlap(AnimalStore& animals, int index, Vector2D posCircle, float radiusCircle);
+	static float computeRadius(int animalTypeID);
+	static SDL_Color getColorOverview(int animalTypeID);
+	static void setRotatedSpriteAngleCount(int angleCount);
+	static void refreshRotatedSprites(SDL_Renderer* renderer);
+	static void registerSpriteAssets();
 
 
 private:
-	void drawTextureWithOffset(SDL_Renderer* renderer, SDL_Texture* textureSelected,
-		int tileSize, int offset);
-	void updateStateIdle(float dT, Game& game);
-	bool updateMove(float dT);
-	bool updateAngle(float dT);
-	void moveToRandomPosition(Game& game);
-	void rotateToRandomAngle();
-	bool checkIfPositionOK(Vector2D posCheck, Game& game);
-	static bool checkIfPositionOkGeneral(Vector2D posCheck, int animalTypeID, Animal* animalExclude,
-		Game& game);
-
-
-	Vector2D pos;
-	float angle;
-	float speed = 1.5f, speedAngular = MathAddon::angleDegToRad(180.0f);
+	static const TypeSprites& loadSprites(SDL_Renderer* renderer, int animalTypeID);
+	static void drawSpriteWithOffset(SDL_Renderer* renderer, SpriteBatch& spriteBatch, AnimalStore& animals,
+		int index, const Sprite& spriteSelected, const Camera& camera, float alpha, int offset, Uint8 alphaMod);
+	static void updateStateIdle(AnimalStore& animals, int index, float dT, World& world);
+	static bool updateMove(AnimalStore& animals, int index, float dT);
+	static bool updateAngle(AnimalStore& animals, int index, float dT);
+	static void moveToRandomPosition(AnimalStore& animals, int index, World& world);
+	static void rotateToRandomAngle(AnimalStore& animals, int index);
+	static bool checkIfPositionOkGeneral(Vector2D posCheck, int animalTypeID, int indexExclude,
+		World& world);
 
-	Timer timerStateIdle;
-	Vector2D directionNormalTarget;
-	float distanceToTarget = 0.0f;
 
-	Timer timerGrowth;
-
-	int typeID;
-
-	SDL_Texture* textureSmallMain = nullptr, * textureSmallShadow = nullptr,
-		* textureMain = nullptr, * textureShadow = nullptr;
+	static const float speed, speedAngular;
 
 	static const std::vector<Type> listAnimalTypes;
+	//Indexed by type id, and filled in by registerSpriteAssets.
+	static std::vector<TypeSprites> listTypeSprites;
+
+	//The animal textures pre-rendered at fixed angles, if enabled.
+	static RotatedSpriteCache rotatedSpriteCache;
 };
\ No newline at end of file
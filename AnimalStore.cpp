@@ -0,0 +1,45 @@
+#include "AnimalStore.h"
+
+
+
+int AnimalStore::add(Uint8 typeID, Vector2D pos, float angle, Timer timerStateIdle, Timer timerGrowth) {
+	listTypeID.push_back(typeID);
+	listState.push_back(State::idle);
+	listPos.push_back(pos);
+	listPosPrevious.push_back(pos);
+	listAngle.push_back(angle);
+	listAnglePrevious.push_back(angle);
+	listTimerStateIdle.push_back(timerStateIdle);
+	listDirectionNormalTarget.push_back(Vector2D());
+	listDistanceToTarget.push_back(0.0f);
+	listTimerGrowth.push_back(timerGrowth);
+
+	slots.add();
+
+	return size() - 1;
+}
+
+
+void AnimalStore::erase(int index) {
+	//Move the last animal into the hole so nothing else has to shift.
+	slots.eraseSwapWithLast(index);
+	SlotMap::swapAndPop(listTypeID, index);
+	SlotMap::swapAndPop(listState, index);
+	SlotMap::swapAndPop(listPos, index);
+	SlotMap::swapAndPop(listPosPrevious, index);
+	SlotMap::swapAndPop(listAngle, index);
+	SlotMap::swapAndPop(listAnglePrevious, index);
+	SlotMap::swapAndPop(listTimerStateIdle, index);
+	SlotMap::swapAndPop(listDirectionNormalTarget, index);
+	SlotMap::swapAndPop(listDistanceToTarget, index);
+	SlotMap::swapAndPop(listTimerGrowth, index);
+}
+
+
+void AnimalStore::eraseQueued() {
+	//The slots stay valid while other animals are erased, so use them to find each index.
+	std::vector<int>& listSlots = slots.getListSlotsEraseQueued();
+	for (int slot : listSlots)
+		erase(slots.getIndexForSlot(slot));
+	listSlots.clear();
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include "SDL2/SDL.h"
+#include "Vector2D.h"
+#include "Timer.h"
+#include "SlotMap.h"
+#include "StoreColumns.h"
+
+
+
+//The data for every animal, stored as one contiguous array per field so that each system only
+//touches the fields that it needs.  An animal is identified by it's index into the arrays, which
+//can change when another animal is erased, or by it's slot, which can't.
+class AnimalStore
+{
+public:
+	enum class State : Uint8 {
+		idle,
+		moving,
+		rotating
+	};
+
+
+	int add(Uint8 typeID, Vector2D pos, float angle, Timer timerStateIdle, Timer timerGrowth);
+	void erase(int index);
+	void queueErase(int index) { slots.queueErase(index); }
+	void eraseQueued();
+	int size() { return (int)listTypeID.size(); }
+
+
+	SlotMap slots;
+
+
+	std::vector<Uint8> listTypeID;
+	std::vector<State> listState;
+	std::vector<Vector2D> listPos, listPosPrevious;
+	std::vector<float> listAngle, listAnglePrevious;
+	std::vector<Timer> listTimerStateIdle;
+	std::vector<Vector2D> listDirectionNormalTarget;
+	std::vector<float> listDistanceToTarget;
+	std::vector<Timer> listTimerGrowth;
+
+
+	//Every array above, which the bytes stored for each animal are worked out from.  Anything
+	//shared by every animal of a type, such as it's sprites, belongs in the type instead.
+	using Columns = StoreColumns<decltype(listTypeID), decltype(listState), decltype(listPos),
+		decltype(listPosPrevious), decltype(listAngle), decltype(listAnglePrevious),
+		decltype(listTimerStateIdle), decltype(listDirectionNormalTarget), decltype(listDistanceToTarget),
+		decltype(listTimerGrowth)>;
+	static const size_t bytesPerAnimal = Columns::computeBytesPerRow();
+	static_assert(bytesPerAnimal <= 56, "A field added to AnimalStore made each animal bigger than expected.");
+};
+
+
+
+static_assert(sizeof(AnimalStore) == AnimalStore::Columns::computeSizeOfStore(sizeof(SlotMap)),
+	"An array in AnimalStore is missing from AnimalStore::Columns.");
\ No newline at end of file
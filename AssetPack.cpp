@@ -0,0 +1,219 @@
+#include "AssetPack.h"
+#include <fstream>
+#include <iterator>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+const char AssetPack::magic[4] = { 'F', 'G', 'P', 'K' };
+
+
+
+AssetPack::~AssetPack() {
+	close();
+}
+
+
+
+bool AssetPack::build(std::string filepathPack, std::string folder,
+	const std::vector<std::string>& listFilenames) {
+	//Write every input file into one pack.  The layout is the magic, the version, the entry count,
+	//then for each entry it's name length, name, offset and size, and then the entries themselves,
+	//each padded to start on a page boundary.  Numbers are little endian.
+	std::vector<std::vector<char>> listContents;
+	for (const auto& filenameSelected : listFilenames) {
+		std::ifstream fileInput(folder + filenameSelected, std::ios::binary);
+		if (fileInput.is_open() == false)
+			return false;
+
+		listContents.emplace_back(std::istreambuf_iterator<char>(fileInput), std::istreambuf_iterator<char>());
+	}
+
+	//Work out the size of the index first so that the offsets of the entries are known.
+	uint64_t sizeIndex = sizeof(magic) + 4 + 4;
+	for (const auto& filenameSelected : listFilenames)
+		sizeIndex += 4 + filenameSelected.size() + 8 + 8;
+
+	std::vector<char> listBytes(magic, magic + sizeof(magic));
+	writeUint32(listBytes, version);
+	writeUint32(listBytes, (uint32_t)listFilenames.size());
+
+	uint64_t offset = sizeIndex;
+	std::vector<uint64_t> listOffsets;
+	for (size_t count = 0; count < listFilenames.size(); count++) {
+		offset = (offset + alignment - 1) / alignment * alignment;
+		listOffsets.push_back(offset);
+
+		writeUint32(listBytes, (uint32_t)listFilenames[count].size());
+		listBytes.insert(listBytes.end(), listFilenames[count].begin(), listFilenames[count].end());
+		writeUint64(listBytes, offset);
+		writeUint64(listBytes, listContents[count].size());
+
+		offset += listContents[count].size();
+	}
+
+	for (size_t count = 0; count < listContents.size(); count++) {
+		listBytes.resize((size_t)listOffsets[count], 0);
+		listBytes.insert(listBytes.end(), listContents[count].begin(), listContents[count].end());
+	}
+
+	std::ofstream fileOutput(filepathPack, std::ios::binary | std::ios::trunc);
+	fileOutput.write(listBytes.data(), listBytes.size());
+	return fileOutput.good();
+}
+
+
+
+bool AssetPack::open(std::string filepathPack) {
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filepathPack.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER sizeFile;
+	HANDLE mapping = NULL;
+	if (GetFileSizeEx(file, &sizeFile) && sizeFile.QuadPart > 0)
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+
+	handleFile = file;
+	handleMapping = mapping;
+	dataMapped = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	sizeMapped = (size_t)sizeFile.QuadPart;
+#else
+	int file = ::open(filepathPack.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat statFile;
+	if (fstat(file, &statFile) == 0 && statFile.st_size > 0) {
+		void* data = mmap(nullptr, (size_t)statFile.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED) {
+			dataMapped = (const unsigned char*)data;
+			sizeMapped = (size_t)statFile.st_size;
+		}
+	}
+	//The mapping stays valid after the file is closed.
+	::close(file);
+#endif
+
+	if (dataMapped == nullptr || readIndex() == false) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+
+void AssetPack::close() {
+#ifdef _WIN32
+	if (dataMapped != nullptr)
+		UnmapViewOfFile(dataMapped);
+	if (handleMapping != nullptr)
+		CloseHandle((HANDLE)handleMapping);
+	if (handleFile != nullptr)
+		CloseHandle((HANDLE)handleFile);
+	handleFile = handleMapping = nullptr;
+#else
+	if (dataMapped != nullptr)
+		munmap((void*)dataMapped, sizeMapped);
+#endif
+
+	dataMapped = nullptr;
+	sizeMapped = 0;
+	umapEntries.clear();
+}
+
+
+
+SDL_RWops* AssetPack::openEntry(const std::string& name) {
+	//Read the entry directly from the mapped file without copying it.  The caller must close the
+	//result, and the pack must stay open while it's used.
+	auto found = umapEntries.find(name);
+	if (found == umapEntries.end())
+		return nullptr;
+
+	return SDL_RWFromConstMem(dataMapped + found->second.offset, (int)found->second.size);
+}
+
+
+
+bool AssetPack::readIndex() {
+	if (sizeMapped < sizeof(magic) || SDL_memcmp(dataMapped, magic, sizeof(magic)) != 0)
+		return false;
+
+	size_t offset = sizeof(magic);
+	uint32_t versionRead = 0, entryCount = 0;
+	if (readUint32(offset, versionRead) == false || versionRead != version ||
+		readUint32(offset, entryCount) == false)
+		return false;
+
+	for (uint32_t count = 0; count < entryCount; count++) {
+		uint32_t nameLength = 0;
+		if (readUint32(offset, nameLength) == false || nameLength > sizeMapped - offset)
+			return false;
+
+		std::string name((const char*)dataMapped + offset, nameLength);
+		offset += nameLength;
+
+		Entry entry;
+		if (readUint64(offset, entry.offset) == false || readUint64(offset, entry.size) == false ||
+			entry.offset > sizeMapped || entry.size > sizeMapped - entry.offset)
+			return false;
+
+		umapEntries[name] = entry;
+	}
+
+	return true;
+}
+
+
+void AssetPack::writeUint32(std::vector<char>& listBytes, uint32_t value) {
+	for (int count = 0; count < 4; count++)
+		listBytes.push_back((char)((value >> (count * 8)) & 0xFF));
+}
+
+
+void AssetPack::writeUint64(std::vector<char>& listBytes, uint64_t value) {
+	for (int count = 0; count < 8; count++)
+		listBytes.push_back((char)((value >> (count * 8)) & 0xFF));
+}
+
+
+bool AssetPack::readUint32(size_t& offset, uint32_t& value) {
+	if (sizeMapped - offset < 4)
+		return false;
+
+	value = 0;
+	for (int count = 0; count < 4; count++)
+		value |= (uint32_t)dataMapped[offset + count] << (count * 8);
+	offset += 4;
+	return true;
+}
+
+
+bool AssetPack::readUint64(size_t& offset, uint64_t& value) {
+	if (sizeMapped - offset < 8)
+		return false;
+
+	value = 0;
+	for (int count = 0; count < 8; count++)
+		value |= (uint64_t)dataMapped[offset + count] << (count * 8);
+	offset += 8;
+	return true;
+}
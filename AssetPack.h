@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "SDL2/SDL.h"
+
+
+
+//A single file holding many assets, so that they can be loaded with one open instead of one per
+//file.  The file starts with an index of the entries' names, offsets and sizes, and each entry
+//starts on a page boundary.  The file is memory mapped once and each entry is read in place.
+class AssetPack
+{
+public:
+	AssetPack() {}
+	~AssetPack();
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	static bool build(std::string filepathPack, std::string folder,
+		const std::vector<std::string>& listFilenames);
+	bool open(std::string filepathPack);
+	void close();
+	bool checkIfOpen() { return (dataMapped != nullptr); }
+	SDL_RWops* openEntry(const std::string& name);
+
+
+private:
+	struct Entry {
+		uint64_t offset = 0, size = 0;
+	};
+
+
+	bool readIndex();
+	static void writeUint32(std::vector<char>& listBytes, uint32_t value);
+	static void writeUint64(std::vector<char>& listBytes, uint64_t value);
+	bool readUint32(size_t& offset, uint32_t& value);
+	bool readUint64(size_t& offset, uint64_t& value);
+
+
+	static const char magic[4];
+	static const uint32_t version = 1;
+	static const uint64_t alignment = 4096;
+
+	const unsigned char* dataMapped = nullptr;
+	size_t sizeMapped = 0;
+#ifdef _WIN32
+	void* handleFile = nullptr, * handleMapping = nullptr;
+#endif
+
+	std::unordered_map<std::string, Entry> umapEntries;
+};
@@ -0,0 +1,103 @@
+#include "Camera.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+Camera::Camera(int setViewWidth, int setViewHeight, int setTileSize) :
+	viewWidth(setViewWidth), viewHeight(setViewHeight), tileSize(setTileSize) {
+
+}
+
+
+
+void Camera::pan(Vector2D offsetPixels) {
+	posTopLeft += offsetPixels / (tileSize * zoom);
+	moved = true;
+}
+
+
+void Camera::zoomAt(float zoomFactor, int xScreen, int yScreen) {
+	//Keep the point under the input screen position in the same place while zooming.
+	Vector2D posWorld = convertScreenToWorld(xScreen, yScreen);
+	zoom = std::min(std::max(zoom * zoomFactor, zoomMin), zoomMax);
+	posTopLeft = posWorld - Vector2D((float)xScreen, (float)yScreen) / (tileSize * zoom);
+	moved = true;
+}
+
+
+void Camera::clampToLevel(int tileCountX, int tileCountY) {
+	//Keep the view over the level, or centered on it if the level is smaller than the view.
+	Vector2D sizeView = Vector2D((float)viewWidth, (float)viewHeight) / (tileSize * zoom);
+	Vector2D posClamped(
+		(sizeView.x >= tileCountX ? (tileCountX - sizeView.x) / 2.0f :
+			std::min(std::max(posTopLeft.x, 0.0f), tileCountX - sizeView.x)),
+		(sizeView.y >= tileCountY ? (tileCountY - sizeView.y) / 2.0f :
+			std::min(std::max(posTopLeft.y, 0.0f), tileCountY - sizeView.y)));
+
+	if (posClamped.x != posTopLeft.x || posClamped.y != posTopLeft.y) {
+		posTopLeft = posClamped;
+		moved = true;
+	}
+}
+
+
+bool Camera::takeMoved() {
+	//Return whether the view changed since the last call.
+	bool movedPrevious = moved;
+	moved = false;
+	return movedPrevious;
+}
+
+
+
+Vector2D Camera::convertScreenToWorld(int xScreen, int yScreen) const {
+	Vector2D pos = posTopLeft;
+	return pos + Vector2D((float)xScreen, (float)yScreen) / (tileSize * zoom);
+}
+
+
+Vector2D Camera::convertWorldToScreen(Vector2D posWorld) const {
+	Vector2D pos = posTopLeft;
+	return (posWorld - pos) * (tileSize * zoom);
+}
+
+
+int Camera::convertWorldToScreenX(float x) const {
+	return (int)std::round((x - posTopLeft.x) * tileSize * zoom);
+}
+
+
+int Camera::convertWorldToScreenY(float y) const {
+	return (int)std::round((y - posTopLeft.y) * tileSize * zoom);
+}
+
+
+SDL_Rect Camera::computeRectScreenForTile(int x, int y) const {
+	//Round both edges of the tile so that neighbouring tiles always meet without gaps.
+	int left = convertWorldToScreenX((float)x);
+	int top = convertWorldToScreenY((float)y);
+	return SDL_Rect{ left, top,
+		convertWorldToScreenX((float)(x + 1)) - left, convertWorldToScreenY((float)(y + 1)) - top };
+}
+
+
+SDL_Rect Camera::computeRectScreen(Vector2D posCenter, int w, int h) const {
+	//The input size is in pixels when the zoom is one.
+	Vector2D posScreen = convertWorldToScreen(posCenter);
+	int wZoomed = (int)std::round(w * zoom);
+	int hZoomed = (int)std::round(h * zoom);
+	return SDL_Rect{ (int)std::round(posScreen.x) - wZoomed / 2, (int)std::round(posScreen.y) - hZoomed / 2,
+		wZoomed, hZoomed };
+}
+
+
+SDL_Rect Camera::computeRectTilesVisible(int tileCountX, int tileCountY) const {
+	//The tiles that are at least partly inside the view, clipped to the level.
+	Vector2D posBottomRight = convertScreenToWorld(viewWidth, viewHeight);
+	int left = std::max((int)std::floor(posTopLeft.x), 0);
+	int top = std::max((int)std::floor(posTopLeft.y), 0);
+	int right = std::min((int)std::ceil(posBottomRight.x), tileCountX);
+	int bottom = std::min((int)std::ceil(posBottomRight.y), tileCountY);
+	return SDL_Rect{ left, top, std::max(right - left, 0), std::max(bottom - top, 0) };
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "Vector2D.h"
+
+
+
+//Maps between the level, measured in tiles, and the window, measured in pixels.  It can be
+//panned and zoomed, and works out which tiles are visible so that only they need to be drawn.
+class Camera
+{
+public:
+	Camera(int setViewWidth, int setViewHeight, int setTileSize);
+	void pan(Vector2D offsetPixels);
+	void zoomAt(float zoomFactor, int xScreen, int yScreen);
+	void clampToLevel(int tileCountX, int tileCountY);
+	bool takeMoved();
+
+	Vector2D convertScreenToWorld(int xScreen, int yScreen) const;
+	Vector2D convertWorldToScreen(Vector2D posWorld) const;
+	SDL_Rect computeRectScreenForTile(int x, int y) const;
+	SDL_Rect computeRectScreen(Vector2D posCenter, int w, int h) const;
+	SDL_Rect computeRectTilesVisible(int tileCountX, int tileCountY) const;
+	float getZoom() const { return zoom; }
+	int getTileSize() const { return tileSize; }
+
+
+private:
+	int convertWorldToScreenX(float x) const;
+	int convertWorldToScreenY(float y) const;
+
+
+	//The position of the top left corner of the view in tiles.
+	Vector2D posTopLeft;
+	float zoom = 1.0f;
+	//Far enough out to see a large level whole, where it's drawn by LevelOverview instead.
+	const float zoomMin = 1.0f / 256.0f, zoomMax = 2.0f;
+
+	const int viewWidth, viewHeight;
+	//The size of a tile in pixels when the zoom is one.
+	const int tileSize;
+
+	//Set whenever the view changes so that anything cached in screen space can be redrawn.
+	bool moved = true;
+};
\ No newline at end of file
@@ -2,58 +2,91 @@
 
 
 
-Game::Game(SDL_Window* window, SDL_Renderer* renderer, int windowWidth, int windowHeight) :
-    placementModeCurrent(PlacementMode::tiles),
-    level(renderer, windowWidth / tileSize + (windowWidth % tileSize > 0),
-        windowHeight / tileSize + (windowHeight % tileSize > 0)) {
-    //Run the game.
-    if (window != nullptr && renderer != nullptr) {
-        //Initialize a texture that will be used to draw the shadows.
-        textureShadows = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
+Game::Game(SDL_Window* setWindow, SDL_Renderer* setRenderer, int windowWidth, int windowHeight) :
+    placementModeCurrent(PlacementMode::tiles), window(setWindow), renderer(setRenderer),
+    world(levelTileCountX, levelTileCountY), camera(windowWidth, windowHeight, tileSize),
+    overview(world.getLevel().getChunkCountX(), world.getLevel().getChunkCountY()) {
+    camera.clampToLevel(world.getLevel().getTileCountX(), world.getLevel().getTileCountY());
+
+    if (renderer != nullptr) {
+        //Initialize a texture that will be used to draw the tiles.
+        textureLevel = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
+            SDL_TEXTUREACCESS_TARGET, windowWidth, windowHeight);
+        SDL_SetTextureBlendMode(textureLevel, SDL_BLENDMODE_NONE);
+
+        //Initialize a texture that will be used to draw the tile shadows.
+        textureShadowsTiles = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
             SDL_TEXTUREACCESS_TARGET, windowWidth, windowHeight);
-        SDL_SetTextureBlendMode(textureShadows, SDL_BLENDMODE_BLEND);
-        SDL_SetTextureAlphaMod(textureShadows, (int)round(255 * 0.60f));
+        SDL_SetTextureBlendMode(textureShadowsTiles, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureAlphaMod(textureShadowsTiles, alphaShadows);
+
+        //Give the plant and animal images their asset ids so that drawing can look them up by index.
+        Plant::registerSpriteAssets();
+        Animal::registerSpriteAssets();
+
+        //Read the images from the asset pack if it's been built, or else from the loose files.
+        //Then decode every image in the manifest in parallel and pack them into atlas pages up
+        //front so that sprites from the same page can be batched together.
+        TextureLoader::openAssetPack("Data/Assets.pack");
+        TextureLoader::loadAtlas(renderer, "Manifest.txt");
+
+        //Load the tile shadows and composite them into their atlas.
+        Tile::loadShadowTextures(renderer);
+    }
+}
+
+
+Game::~Game() {
+    //Clean up.
+    if (textureLevel != nullptr) {
+        SDL_DestroyTexture(textureLevel);
+        textureLevel = nullptr;
+    }
+
+    if (textureShadowsTiles != nullptr) {
+        SDL_DestroyTexture(textureShadowsTiles);
+        textureShadowsTiles = nullptr;
+    }
+
+    TextureLoader::deallocateTextures();
+}
+
 
-        //Store the current times for the clock.
-        auto time1 = std::chrono::system_clock::now();
-        auto time2 = std::chrono::system_clock::now();
+
+void Game::run() {
+    //Run the game.
+    if (window != nullptr && renderer != nullptr) {
+        //Store the current times for the clock.  A steady clock is used so that it never jumps.
+        auto time1 = std::chrono::steady_clock::now();
+        auto time2 = std::chrono::steady_clock::now();
 
 
         //Start the game loop and run until it's time to stop.
         bool running = true;
         while (running) {
             //Determine how much time has elapsed since the last frame.
-            time2 = std::chrono::system_clock::now();
+            time2 = std::chrono::steady_clock::now();
             std::chrono::duration<float> timeDelta = time2 - time1;
             float timeDeltaFloat = timeDelta.count();
 
             //Store the new time for the next frame.
             time1 = time2;
 
-            //The amount of time for each frame (no longer than 20 fps).
-            const float dT = std::min(timeDeltaFloat, 1.0f / 20.0f);
-
-            processEvents(renderer, running);
-            update(dT);
-            draw(renderer);
+            //Run the simulation at it's fixed tick rate, then draw it part way between the last
+            //two ticks based on the time left over.
+            processEvents(running);
+            updateCamera(timeDeltaFloat);
+            world.advance(timeDeltaFloat);
+            //Upload any images that finished decoding in the background.
+            TextureLoader::update(renderer);
+            draw(world.getInterpolationAlpha());
         }
     }
 }
 
 
-Game::~Game() {
-    //Clean up.
-    if (textureShadows != nullptr) {
-        SDL_DestroyTexture(textureShadows);
-        textureShadows = nullptr;
-    }
-
-    TextureLoader::deallocateTextures();
-}
-
-
 
-void Game::processEvents(SDL_Renderer* renderer, bool& running) {
+void Game::processEvents(bool& running) {
     bool mouseDownThisFrame = false;
 
     //Process events.
@@ -64,6 +97,22 @@ void Game::processEvents(SDL_Renderer* renderer, bool& running) {
             running = false;
             break;
 
+        case SDL_RENDER_TARGETS_RESET:
+            //The contents of the target textures were lost so redraw them.
+            Tile::refreshShadowAtlas(renderer);
+            Animal::refreshRotatedSprites(renderer);
+            Plant::refreshScaledSprites(renderer);
+            texturesTilesInvalid = true;
+            break;
+
+        case SDL_MOUSEWHEEL:
+        {   //Zoom in or out around the mouse cursor.
+            int mouseX = 0, mouseY = 0;
+            SDL_GetMouseState(&mouseX, &mouseY);
+            if (event.wheel.y != 0)
+                camera.zoomAt((event.wheel.y > 0 ? 1.25f : 0.8f), mouseX, mouseY); }
+            break;
+
         case SDL_MOUSEBUTTONDOWN:
             mouseDownThisFrame = (mouseDownStatus == 0);
             if (event.button.button == SDL_BUTTON_LEFT)
@@ -72,6 +121,16 @@ void Game::processEvents(SDL_Renderer* renderer, bool& running) {
                 mouseDownStatus = SDL_BUTTON_RIGHT;
             break;
         case SDL_MOUSEBUTTONUP:
+            if (event.button.button == SDL_BUTTON_LEFT && tileEditCurrent == TileEdit::fillRect) {
+                //Fill every tile in the rectangle between where the mouse was pressed and released.
+                Vector2D posMouseUp = camera.convertScreenToWorld(event.button.x, event.button.y);
+                int left = (int)floor(std::min(posMouseDown.x, posMouseUp.x));
+                int top = (int)floor(std::min(posMouseDown.y, posMouseUp.y));
+                int right = (int)floor(std::max(posMouseDown.x, posMouseUp.x));
+                int bottom = (int)floor(std::max(posMouseDown.y, posMouseUp.y));
+                world.fillRectWithTileTypeIDSelected(SDL_Rect{ left, top, right - left + 1, bottom - top + 1 });
+            }
+            tileEditCurrent = TileEdit::brush;
             mouseDownStatus = 0;
             break;
 
@@ -91,10 +150,18 @@ void Game::processEvents(SDL_Renderer* renderer, bool& running) {
             case SDL_SCANCODE_6:
             case SDL_SCANCODE_7:
             {int tileTypeID = event.key.keysym.scancode - SDL_SCANCODE_1;
-            level.setTileTypeIDSelected(tileTypeID);
+            world.setTileTypeIDSelected(tileTypeID);
             placementModeCurrent = PlacementMode::tiles; }
             break;
 
+            //Change the size of the tile brush.
+            case SDL_SCANCODE_LEFTBRACKET:
+                brushRadius = std::max(brushRadius - 1.0f, 0.0f);
+                break;
+            case SDL_SCANCODE_RIGHTBRACKET:
+                brushRadius = std::min(brushRadius + 1.0f, brushRadiusMax);
+                break;
+
             //Select the plants.
             case SDL_SCANCODE_Q:
                 setPlantTypeIDSelected(0);
@@ -131,7 +198,7 @@ void Game::processEvents(SDL_Renderer* renderer, bool& running) {
     int mouseX = 0, mouseY = 0;
     SDL_GetMouseState(&mouseX, &mouseY);
     //Convert from the window's coordinate system to the game's coordinate system.
-    Vector2D posMouse((float)mouseX / tileSize, (float)mouseY / tileSize);
+    Vector2D posMouse = camera.convertScreenToWorld(mouseX, mouseY);
 
     if (mouseDownStatus > 0) {
         //The mouse was pressed.
@@ -139,42 +206,69 @@ void Game::processEvents(SDL_Renderer* renderer, bool& running) {
         case SDL_BUTTON_LEFT:
             switch (placementModeCurrent) {
             case PlacementMode::tiles:
-                level.placeTileTypeIDSelected((int)posMouse.x, (int)posMouse.y);
-                removePlantsIfTilesChanged();
-                removeAnimalsIfTilesChanged();
+                if (mouseDownThisFrame) {
+                    //Holding shift drags out a rectangle that's filled when the mouse is
+                    //released, and holding ctrl flood fills the area under the cursor.
+                    SDL_Keymod keymod = SDL_GetModState();
+                    if (keymod & KMOD_SHIFT) {
+                        tileEditCurrent = TileEdit::fillRect;
+                        posMouseDown = posMouse;
+                    }
+                    else if (keymod & KMOD_CTRL) {
+                        tileEditCurrent = TileEdit::floodFill;
+                        world.floodFillWithTileTypeIDSelected((int)floor(posMouse.x), (int)floor(posMouse.y));
+                    }
+                    else {
+                        tileEditCurrent = TileEdit::brush;
+                        world.paintCircleWithTileTypeIDSelected(posMouse, brushRadius);
+                    }
+                }
+                else if (tileEditCurrent == TileEdit::brush)
+                    //Paint every tile between this and the last sample so fast strokes don't
+                    //leave gaps.
+                    world.paintLineWithTileTypeIDSelected(posMousePrevious, posMouse, brushRadius);
                 break;
             case PlacementMode::plants:
-                addPlant(renderer, posMouse);
+                addPlant(posMouse);
                 break;
             case PlacementMode::animals:
-                addAnimal(renderer, posMouse);
+                addAnimal(posMouse);
                 break;
             }
             break;
 
         case SDL_BUTTON_RIGHT:
-            removePlantsAtMousePosition(posMouse);
-            removeAnimalsAtMousePosition(posMouse);
+            world.removePlantsAtPosition(posMouse);
+            world.removeAnimalsAtPosition(posMouse);
             break;
         }
     }
+
+    posMousePrevious = posMouse;
 }
 
 
 
-void Game::update(float dT) {
-    //Update the plants.
-    for (auto& plantSelected : listPlants)
-        plantSelected.update(dT);
+void Game::updateCamera(float dT) {
+    //Pan with the arrow keys at a constant speed on the screen no matter how far it's zoomed.
+    const Uint8* keyboardState = SDL_GetKeyboardState(NULL);
+    if (keyboardState != nullptr) {
+        Vector2D direction(
+            (float)(keyboardState[SDL_SCANCODE_RIGHT] - keyboardState[SDL_SCANCODE_LEFT]),
+            (float)(keyboardState[SDL_SCANCODE_DOWN] - keyboardState[SDL_SCANCODE_UP]));
+        if (direction.x != 0.0f || direction.y != 0.0f) {
+            const float speedPan = 800.0f;
+            camera.pan(direction * (speedPan * dT));
+        }
+    }
 
-    //Update the animals.
-    for (auto& animalSelected : listAnimals)
-        animalSelected.update(dT, *this);
+    Level& level = world.getLevel();
+    camera.clampToLevel(level.getTileCountX(), level.getTileCountY());
 }
 
 
 
-void Game::draw(SDL_Renderer* renderer) {
+void Game::draw(float alpha) {
     //Draw.
     //Set the background color.
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
@@ -182,40 +276,94 @@ void Game::draw(SDL_Renderer* renderer) {
     SDL_RenderClear(renderer);
 
 
+    //When zoomed far out the level is drawn from the overview's images instead, and the
+    //plants, animals and shadows are too small to be worth drawing one by one.
+    Level& level = world.getLevel();
+    overview.refresh(level);
+    bool cameraMoved = camera.takeMoved();
+    if (overview.checkIfUsedAtZoom(camera.getZoom())) {
+        overview.draw(renderer, world, camera);
+        SDL_RenderPresent(renderer);
+        drawnAsOverview = true;
+        return;
+    }
+
+
     //**********Layer 1 - Level**********
-    level.draw(renderer, tileSize);
+    //The cached textures only hold the view, so they're cleared and every visible tile is
+    //redrawn when the camera moves.  Only the chunks in the view are marked, so this costs the
+    //same no matter how big the level is.
+    if (cameraMoved || texturesTilesInvalid || drawnAsOverview) {
+        drawnAsOverview = false;
+        texturesTilesInvalid = false;
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_SetRenderTarget(renderer, textureLevel);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderTarget(renderer, textureShadowsTiles);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderTarget(renderer, NULL);
+        level.markTilesDirtyInRect(camera.computeRectTilesVisible(level.getTileCountX(), level.getTileCountY()),
+            Level::dirtyColor | Level::dirtyShadows);
+    }
+
+    //Only switch the render target to textureLevel if some of the tiles changed.
+    if (level.checkIfAnyTilesDirty(Level::dirtyColor)) {
+        SDL_SetRenderTarget(renderer, textureLevel);
+        level.drawDirty(renderer, camera);
+        SDL_SetRenderTarget(renderer, NULL);
+    }
+    //Draw the tiles.
+    SDL_RenderCopy(renderer, textureLevel, NULL, NULL);
 
 
     //**********Layer 2 - Shadows**********
-    //Switch the render target to textureShadows and clear it.
-    SDL_SetRenderTarget(renderer, textureShadows);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-    SDL_RenderClear(renderer);
+    //Only switch the render target to textureShadowsTiles if some of the tiles changed.
+    if (level.checkIfAnyTilesDirty(Level::dirtyShadows)) {
+        SDL_SetRenderTarget(renderer, textureShadowsTiles);
+        level.drawShadowsDirty(renderer, camera);
+        SDL_SetRenderTarget(renderer, NULL);
+    }
+    //Draw the tile shadows.
+    SDL_RenderCopy(renderer, textureShadowsTiles, NULL, NULL);
+
+    //Find the plants and animals in the view, with a margin of a tile for their textures and
+    //shadows being bigger than them.  They're drawn in the order they're stored.
+    SDL_Rect rectTilesVisible = camera.computeRectTilesVisible(level.getTileCountX(), level.getTileCountY());
+    Vector2D posVisibleMin(rectTilesVisible.x - 1.0f, rectTilesVisible.y - 1.0f);
+    Vector2D posVisibleMax(rectTilesVisible.x + rectTilesVisible.w + 1.0f,
+        rectTilesVisible.y + rectTilesVisible.h + 1.0f);
 
-    level.drawShadows(renderer, tileSize);
+    const std::vector<int>& listPlantIDsFound = world.queryPlantsInRect(posVisibleMin, posVisibleMax);
+    listPlantIDsVisible.assign(listPlantIDsFound.begin(), listPlantIDsFound.end());
+    std::sort(listPlantIDsVisible.begin(), listPlantIDsVisible.end());
 
-    //Draw the plants shadows.
-    for (auto& plantSelected : listPlants)
-        plantSelected.drawShadow(renderer, tileSize);
+    const std::vector<int>& listAnimalIDsFound = world.queryAnimalsInRect(posVisibleMin, posVisibleMax);
+    listAnimalIDsVisible.assign(listAnimalIDsFound.begin(), listAnimalIDsFound.end());
+    std::sort(listAnimalIDsVisible.begin(), listAnimalIDsVisible.end());
 
-    //Draw the animals shadows.
-    for (auto& animalSelected : listAnimals)
-        animalSelected.drawShadow(renderer, tileSize);
+    //The plants and animals move so draw their shadows directly to the window.  Each layer is
+    //batched and drawn with one call per texture, so the plants and animals are drawn in order of
+    //texture instead of the order they're stored.
+    PlantStore& plants = world.getPlants();
+    for (int plantID : listPlantIDsVisible)
+        Plant::drawShadow(renderer, spriteBatch, plants, plantID, camera, alpha, alphaShadows);
 
-    //Set the render target back to the window.
-    SDL_SetRenderTarget(renderer, NULL);
-    //Draw the texture.
-    SDL_RenderCopy(renderer, textureShadows, NULL, NULL);
+    AnimalStore& animals = world.getAnimals();
+    for (int animalID : listAnimalIDsVisible)
+        Animal::drawShadow(renderer, spriteBatch, animals, animalID, camera, alpha, alphaShadows);
+    spriteBatch.draw(renderer);
 
 
     //**********Layer 3 - Plants**********
     //Draw the plants.
-    for (auto& plantSelected : listPlants)
-        plantSelected.draw(renderer, tileSize);
+    for (int plantID : listPlantIDsVisible)
+        Plant::draw(renderer, spriteBatch, plants, plantID, camera, alpha);
+    spriteBatch.draw(renderer);
 
     //Draw the animals.
-    for (auto& animalSelected : listAnimals)
-        animalSelected.draw(renderer, tileSize);
+    for (int animalID : listAnimalIDsVisible)
+        Animal::draw(renderer, spriteBatch, animals, animalID, camera, alpha);
+    spriteBatch.draw(renderer);
 
 
     //Send the image to the window.
@@ -230,31 +378,12 @@ void Game::setPlantTypeIDSelected(int setPlantTypeIDSelected) {
 }
 
 
-void Game::addPlant(SDL_Renderer* renderer, Vector2D posMouse) {
+void Game::addPlant(Vector2D posMouse) {
     float randOffsetX = (MathAddon::randFloat() * 2.0f - 1.0f) * 0.1f;
     float randOffsetY = (MathAddon::randFloat() * 2.0f - 1.0f) * 0.1f;
     Vector2D pos((int)posMouse.x + 0.5f + randOffsetX, (int)posMouse.y + 0.5f + randOffsetY);
 
-    if (Plant::checkIfPositionOkForType(pos, plantTypeIDSelected, *this))
-        listPlants.push_back(Plant(renderer, plantTypeIDSelected, pos));
-}
-
-
-void Game::removePlantsAtMousePosition(Vector2D posMouse) {
-    for (auto it = listPlants.begin(); it != listPlants.end();)
-        if ((*it).checkOverlapWithMouse((int)posMouse.x, (int)posMouse.y))
-            it = listPlants.erase(it);
-        else
-            it++;
-}
-
-
-void Game::removePlantsIfTilesChanged() {
-    for (auto it = listPlants.begin(); it != listPlants.end();)
-        if ((*it).checkIfTilesUnderOk(level) == false)
-            it = listPlants.erase(it);
-        else
-            it++;
+    world.addPlant(plantTypeIDSelected, pos);
 }
 
 
@@ -265,26 +394,6 @@ void Game::setAnimalTypeIDSelected(int setAnimalTypeIDSelected) {
 }
 
 
-void Game::addAnimal(SDL_Renderer* renderer, Vector2D posMouse) {
-    if (Animal::checkIfPositionOkForType(posMouse, animalTypeIDSelected, *this))
-        listAnimals.push_back(Animal(renderer, animalTypeIDSelected, posMouse,
-            MathAddon::randAngleRad()));
-}
-
-
-void Game::removeAnimalsAtMousePosition(Vector2D posMouse) {
-    for (auto it = listAnimals.begin(); it != listAnimals.end();)
-        if ((*it).checkCircleOverlap(posMouse, 0.0f))
-            it = listAnimals.erase(it);
-        else
-            it++;
-}
-
-
-void Game::removeAnimalsIfTilesChanged() {
-    for (auto it = listAnimals.begin(); it != listAnimals.end();)
-        if ((*it).checkIfTilesUnderOk(level) == false)
-            it = listAnimals.erase(it);
-        else
-            it++;
+void Game::addAnimal(Vector2D posMouse) {
+    world.addAnimal(animalTypeIDSelected, posMouse, MathAddon::randAngleRad());
 }
\ No newline at end of file
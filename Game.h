@@ -1,13 +1,15 @@
 #pragma once
 #include <chrono>
 #include <vector>
+#include <algorithm>
 #include "SDL2/SDL.h"
 #include "TextureLoader.h"
 #include "MathAddon.h"
 #include "Vector2D.h"
-#include "Level.h"
-#include "Plant.h"
-#include "Animal.h"
+#include "World.h"
+#include "Camera.h"
+#include "LevelOverview.h"
+#include "SpriteBatch.h"
 
 
 
@@ -20,41 +22,63 @@ private:
 		animals
 	} placementModeCurrent;
 
+	//How the left mouse button edits the tiles, decided when it's pressed.
+	enum class TileEdit {
+		brush,
+		fillRect,
+		floodFill
+	} tileEditCurrent = TileEdit::brush;
+
 
 public:
-	Game(SDL_Window* window, SDL_Renderer* renderer, int windowWidth, int windowHeight);
+	Game(SDL_Window* setWindow, SDL_Renderer* setRenderer, int windowWidth, int windowHeight);
 	~Game();
-	Level& getLevel() { return level; }
-	std::vector<Plant>& getListPlants() { return listPlants; }
-	std::vector<Animal>& getListAnimals() { return listAnimals; }
+	void run();
+	void setTickRate(int ticksPerSecond) { world.setTickRate(ticksPerSecond); }
 
 
 private:
-	void processEvents(SDL_Renderer* renderer, bool& running);
-	void update(float dT);
-	void draw(SDL_Renderer* renderer);
+	void processEvents(bool& running);
+	void updateCamera(float dT);
+	void draw(float alpha);
 
 	void setPlantTypeIDSelected(int setPlantTypeIDSelected);
-	void addPlant(SDL_Renderer* renderer, Vector2D posMouse);
-	void removePlantsAtMousePosition(Vector2D posMouse);
-	void removePlantsIfTilesChanged();
+	void addPlant(Vector2D posMouse);
 
 	void setAnimalTypeIDSelected(int setAnimalTypeIDSelected);
-	void addAnimal(SDL_Renderer* renderer, Vector2D posMouse);
-	void removeAnimalsAtMousePosition(Vector2D posMouse);
-	void removeAnimalsIfTilesChanged();
+	void addAnimal(Vector2D posMouse);
+
 
+	SDL_Window* window;
+	SDL_Renderer* renderer;
 
 	int mouseDownStatus = 0;
+	Vector2D posMousePrevious;
+	//Where the mouse was pressed, for the corner of a rectangle fill.
+	Vector2D posMouseDown;
+	float brushRadius = 0.0f;
+	const float brushRadiusMax = 8.0f;
 
 	const int tileSize = 64;
-	Level level;
+	//The level can be much bigger than the window since the camera pans around it.
+	const int levelTileCountX = 256, levelTileCountY = 256;
+	World world;
+	Camera camera;
+	LevelOverview overview;
 
 	int plantTypeIDSelected = 0;
 	int animalTypeIDSelected = 0;
 
-	std::vector<Plant> listPlants;
-	std::vector<Animal> listAnimals;
+	//The visible tiles and their shadows are kept between frames and only redrawn where tiles
+	//changed, or completely when the camera moves.
+	SDL_Texture* textureLevel = nullptr;
+	SDL_Texture* textureShadowsTiles = nullptr;
+	bool texturesTilesInvalid = true;
+	const Uint8 alphaShadows = (Uint8)round(255 * 0.60f);
+	bool drawnAsOverview = false;
 
-	SDL_Texture* textureShadows = nullptr;
+	//The plants and animals found inside the view each frame.
+	std::vector<int> listPlantIDsVisible, listAnimalIDsVisible;
+	//Collects the sprites of each layer so that they're drawn with one call per texture.
+	SpriteBatch spriteBatch;
 };
\ No newline at end of file
@@ -1,34 +1,224 @@
 #include "Level.h"
+#include <algorithm>
+#include <thread>
 
 
 
-Level::Level(SDL_Renderer* renderer, int setTileCountX, int setTileCountY) :
-	tileCountX(setTileCountX), tileCountY(setTileCountY) {
+Level::Level(int setTileCountX, int setTileCountY) :
+	tileCountX(setTileCountX), tileCountY(setTileCountY),
+	chunkCountX((setTileCountX + LevelChunk::size - 1) / LevelChunk::size),
+	chunkCountY((setTileCountY + LevelChunk::size - 1) / LevelChunk::size) {
 
-	size_t listTilesSize = (size_t)tileCountX * tileCountY;
-	listTiles.assign(listTilesSize, Tile(renderer));
+	size_t chunkCount = (size_t)chunkCountX * chunkCountY;
+	listChunks.resize(chunkCount);
+	listChunkDirtyFlagsAllTiles.assign(chunkCount, 0);
+	listChunkDirtyListFlags.assign(chunkCount, 0);
+
+	refreshAllShadowMasks();
+}
+
+
+
+SDL_Rect Level::computeChunkRectTiles(int chunkIndex) {
+	//The tiles covered by the chunk, clipped to the level.
+	int x = (chunkIndex % chunkCountX) * LevelChunk::size;
+	int y = (chunkIndex / chunkCountX) * LevelChunk::size;
+	return SDL_Rect{ x, y, std::min(LevelChunk::size, tileCountX - x),
+		std::min(LevelChunk::size, tileCountY - y) };
+}
+
+
+const Tile& Level::getTile(int x, int y) {
+	LevelChunk* chunk = listChunks[computeChunkIndex(x, y)].get();
+	if (chunk != nullptr)
+		return chunk->listTiles[computeIndexInChunk(x, y)];
+
+	return tileDefault;
+}
+
+
+Tile& Level::getTileForWrite(int x, int y) {
+	return getChunkForWrite(computeChunkIndex(x, y)).listTiles[computeIndexInChunk(x, y)];
+}
+
+
+LevelChunk& Level::getChunkForWrite(int chunkIndex) {
+	//Allocate the chunk the first time anything in it changes.
+	std::unique_ptr<LevelChunk>& chunk = listChunks[chunkIndex];
+	if (chunk == nullptr)
+		chunk.reset(new LevelChunk());
+
+	return *chunk;
+}
+
+
+int Level::countChunksAllocated() {
+	int count = 0;
+	for (auto& chunkSelected : listChunks)
+		if (chunkSelected != nullptr)
+			count++;
+
+	return count;
+}
+
+
+
+void Level::drawDirty(SDL_Renderer* renderer, const Camera& camera) {
+	//Redraw only the visible tiles that changed into the current render target, which keeps it's
+	//contents between frames.  The target only holds the view, so the tiles outside it are
+	//drawn when the camera moves over them.
+	takeTilesDirtyEach(dirtyColor, camera.computeRectTilesVisible(tileCountX, tileCountY),
+		[this, renderer, &camera](int x, int y) {
+			getTile(x, y).draw(renderer, x, y, camera.computeRectScreenForTile(x, y));
+		});
+}
+
+
+void Level::drawShadowsDirty(SDL_Renderer* renderer, const Camera& camera) {
+	//Redraw the shadows of only the visible tiles that changed into the current render target,
+	//which keeps it's contents between frames.
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+
+	takeTilesDirtyEach(dirtyShadows, camera.computeRectTilesVisible(tileCountX, tileCountY),
+		[this, renderer, &camera](int x, int y) {
+			//Erase the old shadows then draw the new ones.
+			SDL_Rect rect = camera.computeRectScreenForTile(x, y);
+			SDL_RenderFillRect(renderer, &rect);
+			getTile(x, y).drawShadows(renderer, rect);
+		});
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
 }
 
 
 
-void Level::draw(SDL_Renderer* renderer, int tileSize) {
-	for (int y = 0; y < tileCountY; y++) {
-		for (int x = 0; x < tileCountX; x++) {
-			int index = x + y * tileCountX;
-			listTiles[index].draw(renderer, x, y, tileSize);
+bool Level::checkIfAnyTilesDirty(Uint8 flags) {
+	//A chunk is only removed from a flag's list once none of it's tiles have the flag.
+	for (int flagIndex = 0; flagIndex < dirtyFlagCount; flagIndex++)
+		if ((flags & (1 << flagIndex)) && listChunkIndicesDirtyByFlag[flagIndex].empty() == false)
+			return true;
+
+	return false;
+}
+
+
+void Level::markTilesDirtyInRect(SDL_Rect rectTiles, Uint8 flags) {
+	//Flag the whole of each chunk that overlaps the rectangle, e.g. the view after the camera
+	//moved.  Drawing is clipped to the view, so the extra tiles around it's edges aren't drawn.
+	int left = std::max(rectTiles.x, 0);
+	int top = std::max(rectTiles.y, 0);
+	int right = std::min(rectTiles.x + rectTiles.w, tileCountX);
+	int bottom = std::min(rectTiles.y + rectTiles.h, tileCountY);
+	if (left >= right || top >= bottom)
+		return;
+
+	for (int yChunk = top / LevelChunk::size; yChunk <= (bottom - 1) / LevelChunk::size; yChunk++) {
+		for (int xChunk = left / LevelChunk::size; xChunk <= (right - 1) / LevelChunk::size; xChunk++) {
+			int chunkIndex = xChunk + yChunk * chunkCountX;
+			listChunkDirtyFlagsAllTiles[chunkIndex] |= flags;
+			addChunkToDirtyLists(chunkIndex, flags);
 		}
 	}
 }
 
 
-void Level::drawShadows(SDL_Renderer* renderer, int tileSize) {
-	for (int y = 0; y < tileCountY; y++) {
-		for (int x = 0; x < tileCountX; x++) {
-			int index = x + y * tileCountX;
-			listTiles[index].drawShadows(renderer, x, y, tileSize,
-				listTiles, tileCountX, tileCountY);
+void Level::takeTilesDirty(Uint8 flag, std::vector<int>& listTileIndicesOut) {
+	//Output the indices of the tiles that have the flag set and clear it.  Each tile is only
+	//output once no matter how many times it changed since the last call.
+	takeTilesDirtyEach(flag, SDL_Rect{ 0, 0, tileCountX, tileCountY },
+		[this, &listTileIndicesOut](int x, int y) {
+			listTileIndicesOut.push_back(x + y * tileCountX);
+		});
+}
+
+
+void Level::takeChunksDirty(Uint8 flag, std::vector<int>& listChunkIndicesOut) {
+	//Output the indices of the chunks that have any tiles with the flag set and clear it.
+	int flagIndex = computeDirtyFlagIndex(flag);
+	for (int chunkIndex : listChunkIndicesDirtyByFlag[flagIndex]) {
+		bool isDirty = false;
+		if (listChunkDirtyFlagsAllTiles[chunkIndex] & flag) {
+			listChunkDirtyFlagsAllTiles[chunkIndex] &= ~flag;
+			isDirty = true;
+		}
+
+		LevelChunk* chunk = listChunks[chunkIndex].get();
+		if (chunk != nullptr) {
+			for (int indexInChunk : chunk->listTileIndicesDirty) {
+				if (chunk->listTileDirtyFlags[indexInChunk] & flag) {
+					chunk->listTileDirtyFlags[indexInChunk] &= ~flag;
+					isDirty = true;
+				}
+			}
 		}
+
+		if (isDirty)
+			listChunkIndicesOut.push_back(chunkIndex);
 	}
+
+	removeCleanChunksFromDirtyList(flagIndex);
+}
+
+
+void Level::markTileDirty(int x, int y, Uint8 flags) {
+	//Only add the tile to it's chunk's list the first time it's flagged.
+	int chunkIndex = computeChunkIndex(x, y);
+	LevelChunk& chunk = getChunkForWrite(chunkIndex);
+	int indexInChunk = computeIndexInChunk(x, y);
+	if (chunk.listTileDirtyFlags[indexInChunk] == 0)
+		chunk.listTileIndicesDirty.push_back(indexInChunk);
+
+	chunk.listTileDirtyFlags[indexInChunk] |= flags;
+	addChunkToDirtyLists(chunkIndex, flags);
+}
+
+
+void Level::addChunkToDirtyLists(int chunkIndex, Uint8 flags) {
+	Uint8 flagsNew = (flags & ~listChunkDirtyListFlags[chunkIndex]);
+	if (flagsNew != 0) {
+		listChunkDirtyListFlags[chunkIndex] |= flagsNew;
+		for (int flagIndex = 0; flagIndex < dirtyFlagCount; flagIndex++)
+			if (flagsNew & (1 << flagIndex))
+				listChunkIndicesDirtyByFlag[flagIndex].push_back(chunkIndex);
+	}
+}
+
+
+void Level::removeCleanChunksFromDirtyList(int flagIndex) {
+	//Remove the tiles that have no flags left from each chunk's list, then the chunks that have
+	//no tiles left with this flag from it's list.
+	Uint8 flag = (Uint8)(1 << flagIndex);
+	std::vector<int>& listChunkIndicesDirty = listChunkIndicesDirtyByFlag[flagIndex];
+	listChunkIndicesDirty.erase(std::remove_if(listChunkIndicesDirty.begin(), listChunkIndicesDirty.end(),
+		[this, flag](int chunkIndex) {
+			bool isClean = ((listChunkDirtyFlagsAllTiles[chunkIndex] & flag) == 0);
+			LevelChunk* chunk = listChunks[chunkIndex].get();
+			if (chunk != nullptr) {
+				chunk->listTileIndicesDirty.erase(std::remove_if(chunk->listTileIndicesDirty.begin(),
+					chunk->listTileIndicesDirty.end(), [chunk](int indexInChunk) {
+						return chunk->listTileDirtyFlags[indexInChunk] == 0; }),
+					chunk->listTileIndicesDirty.end());
+
+				for (int indexInChunk : chunk->listTileIndicesDirty)
+					if (chunk->listTileDirtyFlags[indexInChunk] & flag)
+						isClean = false;
+			}
+
+			if (isClean)
+				listChunkDirtyListFlags[chunkIndex] &= ~flag;
+			return isClean;
+		}), listChunkIndicesDirty.end());
+}
+
+
+int Level::computeDirtyFlagIndex(Uint8 flag) {
+	//The flags are single bits, so this is the position of the bit.
+	int flagIndex = 0;
+	while (flagIndex < dirtyFlagCount - 1 && (flag & (1 << flagIndex)) == 0)
+		flagIndex++;
+
+	return flagIndex;
 }
 
 
@@ -39,24 +229,439 @@ void Level::setTileTypeIDSelected(int setTileTypeIDSelected) {
 
 
 void Level::placeTileTypeIDSelected(int x, int y) {
-	int index = x + y * tileCountX;
-	if (index > -1 && index < listTiles.size() &&
-		x > -1 && x < tileCountX &&
-		y > -1 && y < tileCountY) {
-		listTiles[index].setTypeID(tileTypeIDSelected);
+	if (checkIfInBounds(x, y)) {
+		listTileIndicesEdit.clear();
+		listTileIndicesEdit.push_back(x + y * tileCountX);
+		placeTileTypeIDSelectedInList(listTileIndicesEdit);
+	}
+}
+
+
+void Level::fillRectWithTileTypeIDSelected(SDL_Rect rectTiles) {
+	listTileIndicesEdit.clear();
+	for (int y = std::max(rectTiles.y, 0); y < std::min(rectTiles.y + rectTiles.h, tileCountY); y++)
+		for (int x = std::max(rectTiles.x, 0); x < std::min(rectTiles.x + rectTiles.w, tileCountX); x++)
+			listTileIndicesEdit.push_back(x + y * tileCountX);
+
+	placeTileTypeIDSelectedInList(listTileIndicesEdit);
+}
+
+
+void Level::paintCircleWithTileTypeIDSelected(Vector2D posCenter, float radius) {
+	listTileIndicesEdit.clear();
+	addCircleToList(posCenter, radius, listTileIndicesEdit);
+	placeTileTypeIDSelectedInList(listTileIndicesEdit);
+}
+
+
+void Level::paintLineWithTileTypeIDSelected(Vector2D posStart, Vector2D posEnd, float radius) {
+	//Stamp the brush at points along the line that are close enough together that there are no
+	//gaps between them, e.g. between two samples of the mouse cursor that moved quickly.
+	const float distanceStep = 0.25f;
+	int stepCount = (int)ceil((posEnd - posStart).magnitude() / distanceStep);
+
+	listTileIndicesEdit.clear();
+	for (int count = 0; count <= stepCount; count++) {
+		float fraction = (stepCount > 0 ? (float)count / stepCount : 0.0f);
+		addCircleToList(posStart + (posEnd - posStart) * fraction, radius, listTileIndicesEdit);
+	}
+
+	//The stamps overlap so remove the tiles that were added more than once.
+	std::sort(listTileIndicesEdit.begin(), listTileIndicesEdit.end());
+	listTileIndicesEdit.erase(std::unique(listTileIndicesEdit.begin(), listTileIndicesEdit.end()),
+		listTileIndicesEdit.end());
+
+	placeTileTypeIDSelectedInList(listTileIndicesEdit);
+}
+
+
+bool Level::floodFillWithTileTypeIDSelected(int x, int y) {
+	//Replace the area of tiles that are connected to the input tile and the same type as it.
+	//Return false without changing anything if there's nothing to replace or the area is too big.
+	if (checkIfInBounds(x, y) == false)
+		return false;
+
+	Tile::TypeID typeIDReplace = getTile(x, y).getTypeID();
+	if ((int)typeIDReplace == tileTypeIDSelected)
+		return false;
+
+	//The tiles are only changed after the area is found, so mark the ones that have been visited.
+	if (listTileVisited.empty())
+		listTileVisited.resize((size_t)tileCountX * tileCountY, false);
+
+	listTileIndicesToVisit.clear();
+	listTileIndicesToVisit.push_back(x + y * tileCountX);
+	listTileVisited[x + y * tileCountX] = true;
+
+	listTileIndicesEdit.clear();
+	while (listTileIndicesToVisit.empty() == false &&
+		(int)listTileIndicesEdit.size() <= floodFillTileCountMax) {
+		int index = listTileIndicesToVisit.back();
+		listTileIndicesToVisit.pop_back();
+		listTileIndicesEdit.push_back(index);
+
+		int xSelected = index % tileCountX;
+		int ySelected = index / tileCountX;
+		const int listOffsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+		for (auto& offset : listOffsets) {
+			int x2 = xSelected + offset[0];
+			int y2 = ySelected + offset[1];
+			if (checkIfInBounds(x2, y2)) {
+				int index2 = x2 + y2 * tileCountX;
+				if (listTileVisited[index2] == false && getTile(x2, y2).getTypeID() == typeIDReplace) {
+					listTileVisited[index2] = true;
+					listTileIndicesToVisit.push_back(index2);
+				}
+			}
+		}
+	}
+
+	//Every marked tile is either in the area found so far or still waiting to be visited.
+	for (int index : listTileIndicesEdit)
+		listTileVisited[index] = false;
+	for (int index : listTileIndicesToVisit)
+		listTileVisited[index] = false;
+
+	if ((int)listTileIndicesEdit.size() > floodFillTileCountMax)
+		return false;
+
+	placeTileTypeIDSelectedInList(listTileIndicesEdit);
+	return true;
+}
+
+
+void Level::addCircleToList(Vector2D posCenter, float radius, std::vector<int>& listTileIndicesOut) {
+	//Add the tile under the center and every tile whose center is within the radius.
+	int left = std::max((int)floor(posCenter.x - radius), 0);
+	int top = std::max((int)floor(posCenter.y - radius), 0);
+	int right = std::min((int)floor(posCenter.x + radius), tileCountX - 1);
+	int bottom = std::min((int)floor(posCenter.y + radius), tileCountY - 1);
+	int xCenter = (int)floor(posCenter.x);
+	int yCenter = (int)floor(posCenter.y);
+
+	for (int y = top; y <= bottom; y++)
+		for (int x = left; x <= right; x++)
+			if ((x == xCenter && y == yCenter) ||
+				(Vector2D(x + 0.5f, y + 0.5f) - posCenter).magnitude() <= radius)
+				listTileIndicesOut.push_back(x + y * tileCountX);
+}
+
+
+void Level::placeTileTypeIDSelectedInList(std::vector<int>& listTileIndices) {
+	//Change the type of all the tiles first, then refresh what depends on them once for all of
+	//the tiles that actually changed.
+	listTileIndicesChanged.clear();
+	listTileIndicesWaterChanged.clear();
+	for (int index : listTileIndices) {
+		int x = index % tileCountX;
+		int y = index / tileCountX;
+		if ((int)getTile(x, y).getTypeID() != tileTypeIDSelected) {
+			Tile& tileSelected = getTileForWrite(x, y);
+			bool wasWater = tileSelected.checkIfWater();
+			if (tileSelected.setTypeID(tileTypeIDSelected)) {
+				markTileDirty(x, y, dirtyColor | dirtyEntities | dirtyOverview);
+				listTileIndicesChanged.push_back(index);
+
+				bool isWater = tileSelected.checkIfWater();
+				if (isWater != wasWater) {
+					listTileIndicesWaterChanged.push_back(index);
+					listChunks[computeChunkIndex(x, y)]->waterTileCount += (isWater ? 1 : -1);
+				}
+			}
+		}
+	}
+
+	if (listTileIndicesChanged.empty())
+		return;
+
+	//Update the water counts around the tiles that became or stopped being water.  If so many
+	//changed that it would touch more tiles than the level has then recount them all instead.
+	int sizeArea = (wetDistance * 2 + 1) * (wetDistance * 2 + 1);
+	if (listTileIndicesWaterChanged.size() * sizeArea > (size_t)tileCountX * tileCountY)
+		refreshAllWaterCounts();
+	else
+		for (int index : listTileIndicesWaterChanged)
+			addToWaterCountsAround(index % tileCountX, index / tileCountX,
+				(getTile(index % tileCountX, index / tileCountX).checkIfWater() ? 1 : -1));
+
+	//A tile's height only affects the shadows of itself and the tiles directly around it.
+	listTileIndicesShadows.clear();
+	for (int index : listTileIndicesChanged) {
+		int x = index % tileCountX;
+		int y = index / tileCountX;
+		for (int y2 = std::max(y - 1, 0); y2 <= std::min(y + 1, tileCountY - 1); y2++)
+			for (int x2 = std::max(x - 1, 0); x2 <= std::min(x + 1, tileCountX - 1); x2++)
+				listTileIndicesShadows.push_back(x2 + y2 * tileCountX);
+	}
+	std::sort(listTileIndicesShadows.begin(), listTileIndicesShadows.end());
+	listTileIndicesShadows.erase(std::unique(listTileIndicesShadows.begin(), listTileIndicesShadows.end()),
+		listTileIndicesShadows.end());
+
+	for (int index : listTileIndicesShadows)
+		refreshShadowMask(index % tileCountX, index / tileCountX);
+}
+
+
+
+void Level::refreshShadowMask(int x, int y) {
+	//Only write the mask if it changed so that a chunk isn't allocated just to store the default.
+	Uint8 shadowMask = computeShadowMask(x, y);
+	if (getTile(x, y).getShadowMask() != shadowMask) {
+		getTileForWrite(x, y).setShadowMask(shadowMask);
+		markTileDirty(x, y, dirtyShadows);
+	}
+}
+
+
+Uint8 Level::computeShadowMask(int x, int y) {
+	//Gather the types of the tiles around it, which can be in other chunks.  Tiles outside of
+	//the level are treated as the same type as the center so they never cast a shadow on it.
+	Tile::TypeID typeIDCenter = getTile(x, y).getTypeID();
+	Tile::TypeID listTypeIDsAround[9];
+	for (int yOff = -1; yOff <= 1; yOff++)
+		for (int xOff = -1; xOff <= 1; xOff++)
+			listTypeIDsAround[(xOff + 1) + (yOff + 1) * 3] = (checkIfInBounds(x + xOff, y + yOff) ?
+				getTile(x + xOff, y + yOff).getTypeID() : typeIDCenter);
+
+	return Tile::computeShadowMask(listTypeIDsAround);
+}
+
+
+
+void Level::addToWaterCountsAround(int x, int y, int amount) {
+	//Each tile stores how many water tiles are within wetDistance of it, so adding or removing
+	//water only needs to adjust the counts of the tiles around it.  These can be in other chunks.
+	for (int y2 = std::max(y - wetDistance, 0); y2 <= std::min(y + wetDistance, tileCountY - 1); y2++)
+		for (int x2 = std::max(x - wetDistance, 0); x2 <= std::min(x + wetDistance, tileCountX - 1); x2++)
+			setWaterCountForTile(x2, y2, getTile(x2, y2).getWaterCount() + amount);
+}
+
+
+void Level::setWaterCountForTile(int x, int y, int waterCount) {
+	if (getTile(x, y).getWaterCount() != waterCount) {
+		if (getTileForWrite(x, y).setWaterCount(waterCount)) {
+			//It changed between wet and dry.
+			markTileDirty(x, y, dirtyColor | dirtyEntities | dirtyOverview);
+
+			LevelChunk& chunk = *listChunks[computeChunkIndex(x, y)];
+			chunk.wetTileCount += (getTile(x, y).checkIfWet() ? 1 : -1);
+			chunk.tableWetIsDirty = true;
+		}
+	}
+}
+
+
+void Level::setWetDistance(int setWetDistance) {
+	if (setWetDistance > wetDistanceMax)
+		setWetDistance = wetDistanceMax;
+
+	if (setWetDistance > -1 && setWetDistance != wetDistance) {
+		wetDistance = setWetDistance;
+		refreshAllWaterCounts();
+	}
+}
+
+
+void Level::refreshAllWaterCounts() {
+	for (int chunkIndex = 0; chunkIndex < (int)listChunks.size(); chunkIndex++)
+		refreshWaterCountsInChunk(chunkIndex);
+}
+
+
+void Level::refreshWaterCountsInChunk(int chunkIndex) {
+	SDL_Rect rectChunk = computeChunkRectTiles(chunkIndex);
+
+	//Check the chunks that are close enough to spread water into this one.  If none of them
+	//have any water then every count is zero.
+	bool isWaterNear = false;
+	int chunkLeft = std::max(rectChunk.x - wetDistance, 0) / LevelChunk::size;
+	int chunkTop = std::max(rectChunk.y - wetDistance, 0) / LevelChunk::size;
+	int chunkRight = std::min(rectChunk.x + rectChunk.w - 1 + wetDistance, tileCountX - 1) / LevelChunk::size;
+	int chunkBottom = std::min(rectChunk.y + rectChunk.h - 1 + wetDistance, tileCountY - 1) / LevelChunk::size;
+	for (int yChunk = chunkTop; yChunk <= chunkBottom; yChunk++) {
+		for (int xChunk = chunkLeft; xChunk <= chunkRight; xChunk++) {
+			LevelChunk* chunkOther = listChunks[xChunk + yChunk * chunkCountX].get();
+			if (chunkOther != nullptr && chunkOther->waterTileCount > 0)
+				isWaterNear = true;
+		}
+	}
 
-		Tile::refreshSurroundingIsWet(x, y, listTiles, tileCountX, tileCountY);
+	if (isWaterNear == false) {
+		//An unallocated chunk already has every count at zero.
+		if (listChunks[chunkIndex] != nullptr)
+			for (int y = rectChunk.y; y < rectChunk.y + rectChunk.h; y++)
+				for (int x = rectChunk.x; x < rectChunk.x + rectChunk.w; x++)
+					setWaterCountForTile(x, y, 0);
+		return;
+	}
+
+	//Use a summed area table of the water tiles in and around the chunk so that each tile's
+	//count is found in constant time no matter how far the water spreads.
+	int windowX = rectChunk.x - wetDistance;
+	int windowY = rectChunk.y - wetDistance;
+	int windowCountX = rectChunk.w + wetDistance * 2;
+	int windowCountY = rectChunk.h + wetDistance * 2;
+	listWindowIsWater.assign((size_t)windowCountX * windowCountY, 0);
+	for (int y = 0; y < windowCountY; y++)
+		for (int x = 0; x < windowCountX; x++)
+			if (checkIfInBounds(windowX + x, windowY + y) && getTile(windowX + x, windowY + y).checkIfWater())
+				listWindowIsWater[x + y * windowCountX] = 1;
+
+	buildSummedAreaTable(listWindowIsWater, windowCountX, windowCountY, listWindowTableWater);
+
+	for (int y = rectChunk.y; y < rectChunk.y + rectChunk.h; y++) {
+		for (int x = rectChunk.x; x < rectChunk.x + rectChunk.w; x++) {
+			SDL_Rect rect = { x - wetDistance - windowX, y - wetDistance - windowY,
+				wetDistance * 2 + 1, wetDistance * 2 + 1 };
+			setWaterCountForTile(x, y,
+				sumSummedAreaTable(listWindowTableWater, windowCountX, windowCountY, rect));
+		}
+	}
+}
+
+
+
+int Level::countWetTilesInRect(SDL_Rect rectTiles) {
+	//Clip the rectangle to the level.
+	int left = std::max(rectTiles.x, 0);
+	int top = std::max(rectTiles.y, 0);
+	int right = std::min(rectTiles.x + rectTiles.w, tileCountX);
+	int bottom = std::min(rectTiles.y + rectTiles.h, tileCountY);
+	if (left >= right || top >= bottom)
+		return 0;
+
+	//Use the total of each chunk that's completely inside the rectangle, and the chunk's summed
+	//area table for the ones at the edges that are only partly inside, so each chunk costs the
+	//same no matter how much of it is covered.
+	int count = 0;
+	for (int yChunk = top / LevelChunk::size; yChunk <= (bottom - 1) / LevelChunk::size; yChunk++) {
+		for (int xChunk = left / LevelChunk::size; xChunk <= (right - 1) / LevelChunk::size; xChunk++) {
+			int chunkIndex = xChunk + yChunk * chunkCountX;
+			LevelChunk* chunk = listChunks[chunkIndex].get();
+			if (chunk == nullptr || chunk->wetTileCount == 0)
+				continue;
+
+			SDL_Rect rectChunk = computeChunkRectTiles(chunkIndex);
+			int left2 = std::max(left, rectChunk.x);
+			int top2 = std::max(top, rectChunk.y);
+			int right2 = std::min(right, rectChunk.x + rectChunk.w);
+			int bottom2 = std::min(bottom, rectChunk.y + rectChunk.h);
+			if ((right2 - left2) == rectChunk.w && (bottom2 - top2) == rectChunk.h)
+				count += chunk->wetTileCount;
+			else {
+				if (chunk->tableWetIsDirty)
+					refreshTableWetInChunk(chunkIndex);
+
+				count += sumSummedAreaTable(chunk->listTableWet, rectChunk.w, rectChunk.h,
+					SDL_Rect{ left2 - rectChunk.x, top2 - rectChunk.y, right2 - left2, bottom2 - top2 });
+			}
+		}
+	}
+
+	return count;
+}
+
+
+void Level::refreshTableWetInChunk(int chunkIndex) {
+	LevelChunk& chunk = *listChunks[chunkIndex];
+	SDL_Rect rectChunk = computeChunkRectTiles(chunkIndex);
+
+	listChunkIsWet.assign((size_t)rectChunk.w * rectChunk.h, 0);
+	for (int y = 0; y < rectChunk.h; y++)
+		for (int x = 0; x < rectChunk.w; x++)
+			if (chunk.listTiles[computeIndexInChunk(rectChunk.x + x, rectChunk.y + y)].checkIfWet())
+				listChunkIsWet[x + y * rectChunk.w] = 1;
+
+	buildSummedAreaTable(listChunkIsWet, rectChunk.w, rectChunk.h, chunk.listTableWet);
+	chunk.tableWetIsDirty = false;
+}
+
+
+
+void Level::buildSummedAreaTable(const std::vector<Uint8>& listValues, int countX, int countY,
+	std::vector<int>& listTableOut) {
+	//The table has an extra row and column of zeros at the top and left, so each entry is the
+	//sum of all the values above and to the left of it.
+	int tableCountX = countX + 1;
+	listTableOut.assign((size_t)tableCountX * (countY + 1), 0);
+
+	for (int y = 0; y < countY; y++) {
+		int sumRow = 0;
+		for (int x = 0; x < countX; x++) {
+			sumRow += listValues[x + y * countX];
+			listTableOut[(x + 1) + (y + 1) * tableCountX] = sumRow + listTableOut[(x + 1) + y * tableCountX];
+		}
+	}
+}
+
+
+int Level::sumSummedAreaTable(const std::vector<int>& listTable, int countX, int countY,
+	SDL_Rect rect) {
+	//Clip the rectangle to the table then combine the sums at it's four corners.
+	int left = std::max(rect.x, 0);
+	int top = std::max(rect.y, 0);
+	int right = std::min(rect.x + rect.w, countX);
+	int bottom = std::min(rect.y + rect.h, countY);
+	if (left >= right || top >= bottom)
+		return 0;
+
+	int tableCountX = countX + 1;
+	return listTable[right + bottom * tableCountX] - listTable[left + bottom * tableCountX] -
+		listTable[right + top * tableCountX] + listTable[left + top * tableCountX];
+}
+
+
+
+void Level::refreshAllShadowMasks() {
+	//Each tile's mask only reads the types of the tiles around it, so the allocated chunks can be
+	//split up between threads.  The tiles of unallocated chunks are all the default type, which
+	//is the highest, so they never have shadows.  This is used when a whole level is setup at once.
+	std::vector<int> listChunkIndicesAllocated;
+	for (int chunkIndex = 0; chunkIndex < (int)listChunks.size(); chunkIndex++)
+		if (listChunks[chunkIndex] != nullptr)
+			listChunkIndicesAllocated.push_back(chunkIndex);
+
+	auto refreshChunks = [this, &listChunkIndicesAllocated](int first, int last) {
+		for (int count = first; count < last; count++) {
+			int chunkIndex = listChunkIndicesAllocated[count];
+			SDL_Rect rect = computeChunkRectTiles(chunkIndex);
+			for (int y = rect.y; y < rect.y + rect.h; y++)
+				for (int x = rect.x; x < rect.x + rect.w; x++)
+					listChunks[chunkIndex]->listTiles[computeIndexInChunk(x, y)].setShadowMask(
+						computeShadowMask(x, y));
+		}
+	};
+
+	//Starting threads is only worth it when there are enough chunks to split between them, so a
+	//new level with none allocated doesn't start any.
+	const int chunkCountPerThreadMin = 16;
+	int chunkCountAllocated = (int)listChunkIndicesAllocated.size();
+	int threadCount = std::min((int)std::thread::hardware_concurrency(),
+		chunkCountAllocated / chunkCountPerThreadMin);
+
+	if (threadCount < 2)
+		refreshChunks(0, chunkCountAllocated);
+	else {
+		std::vector<std::thread> listThreads;
+		for (int count = 0; count < threadCount; count++)
+			listThreads.push_back(std::thread(refreshChunks, chunkCountAllocated * count / threadCount,
+				chunkCountAllocated * (count + 1) / threadCount));
+
+		for (auto& threadSelected : listThreads)
+			threadSelected.join();
+	}
+
+	for (int chunkIndex : listChunkIndicesAllocated) {
+		listChunkDirtyFlagsAllTiles[chunkIndex] |= dirtyShadows;
+		addChunkToDirtyLists(chunkIndex, dirtyShadows);
 	}
 }
 
 
 
 bool Level::checkIfTileOkForPlant(int x, int y, bool growsOnWetDirt) {
-	int index = x + y * tileCountX;
-	if (index > -1 && index < listTiles.size() &&
-		x > -1 && x < tileCountX &&
-		y > -1 && y < tileCountY)
-		return listTiles[index].checkIfOkForPlant(growsOnWetDirt);
+	if (checkIfInBounds(x, y))
+		return getTile(x, y).checkIfOkForPlant(growsOnWetDirt);
 
 	return false;
 }
@@ -82,13 +687,54 @@ bool Level::checkIfPositionOkForAnimal(Vector2D posCircle, float radiusCircle) {
 		//Loop through all the tiles for the above rectangle.
 		for (int y = rectTop; y <= rectBottom; y++) {
 			for (int x = rectLeft; x <= rectRight; x++) {
-				int index = x + y * tileCountX;
 				//Check if the input circle overlaps the tile and if it's type is ok.
-				if (listTiles[index].checkIfOkForAnimal(x, y, posCircle, radiusCircle) == false)
+				if (getTile(x, y).checkIfOkForAnimal(x, y, posCircle, radiusCircle) == false)
 					return false;
 			}
 		}
 	}
 
+	return true;
+}
+
+
+
+void Level::setPlantIDForTiles(SDL_Rect rectTiles, int plantID) {
+	for (int y = std::max(rectTiles.y, 0); y < std::min(rectTiles.y + rectTiles.h, tileCountY); y++) {
+		for (int x = std::max(rectTiles.x, 0); x < std::min(rectTiles.x + rectTiles.w, tileCountX); x++) {
+			//Clearing a tile doesn't need a chunk to be allocated.
+			int chunkIndex = computeChunkIndex(x, y);
+			if (plantID == -1 && listChunks[chunkIndex] == nullptr)
+				continue;
+
+			LevelChunk& chunk = getChunkForWrite(chunkIndex);
+			int& plantIDSelected = chunk.listPlantIDs[computeIndexInChunk(x, y)];
+			if (plantIDSelected != plantID) {
+				chunk.plantTileCount += (plantID != -1 ? 1 : 0) - (plantIDSelected != -1 ? 1 : 0);
+				plantIDSelected = plantID;
+				markTileDirty(x, y, dirtyOverview);
+			}
+		}
+	}
+}
+
+
+int Level::getPlantIDForTile(int x, int y) {
+	if (checkIfInBounds(x, y)) {
+		LevelChunk* chunk = listChunks[computeChunkIndex(x, y)].get();
+		if (chunk != nullptr && chunk->plantTileCount > 0)
+			return chunk->listPlantIDs[computeIndexInChunk(x, y)];
+	}
+
+	return -1;
+}
+
+
+bool Level::checkIfTilesFreeOfPlants(SDL_Rect rectTiles) {
+	for (int y = rectTiles.y; y < rectTiles.y + rectTiles.h; y++)
+		for (int x = rectTiles.x; x < rectTiles.x + rectTiles.w; x++)
+			if (getPlantIDForTile(x, y) != -1)
+				return false;
+
 	return true;
 }
\ No newline at end of file
@@ -1,26 +1,177 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <array>
+#include <algorithm>
 #include "SDL2/SDL.h"
 #include "Tile.h"
+#include "LevelChunk.h"
 #include "Vector2D.h"
+#include "Camera.h"
 
 
 
+//The tiles are stored in chunks of LevelChunk::size by LevelChunk::size tiles.  A chunk that has
+//never been changed isn't allocated and reads as default tiles, so the level can be much larger
+//than the part of it that's actually used.
 class Level
 {
 public:
-	Level(SDL_Renderer* renderer, int setTileCountX, int setTileCountY);
-	void draw(SDL_Renderer* renderer, int tileSize);
-	void drawShadows(SDL_Renderer* renderer, int tileSize);
+	//What needs to be redrawn for a tile since it was last drawn into a cached texture, and
+	//whether the entities on it need to be checked since it's type or wetness changed.
+	enum DirtyFlag : Uint8 {
+		dirtyColor = 1 << 0,
+		dirtyShadows = 1 << 1,
+		dirtyEntities = 1 << 2,
+		//The tile's color or the plant on it changed, for the zoomed out overview.
+		dirtyOverview = 1 << 3
+	};
+	static const int dirtyFlagCount = 4;
+
+
+	Level(int setTileCountX, int setTileCountY);
+	void drawDirty(SDL_Renderer* renderer, const Camera& camera);
+	void drawShadowsDirty(SDL_Renderer* renderer, const Camera& camera);
+	bool checkIfAnyTilesDirty(Uint8 flags);
+	void markTilesDirtyInRect(SDL_Rect rectTiles, Uint8 flags);
+	void takeTilesDirty(Uint8 flag, std::vector<int>& listTileIndicesOut);
+	void takeChunksDirty(Uint8 flag, std::vector<int>& listChunkIndicesOut);
 	void setTileTypeIDSelected(int setTileTypeIDSelected);
 	void placeTileTypeIDSelected(int x, int y);
+	void fillRectWithTileTypeIDSelected(SDL_Rect rectTiles);
+	void paintCircleWithTileTypeIDSelected(Vector2D posCenter, float radius);
+	void paintLineWithTileTypeIDSelected(Vector2D posStart, Vector2D posEnd, float radius);
+	bool floodFillWithTileTypeIDSelected(int x, int y);
 	bool checkIfTileOkForPlant(int x, int y, bool growsOnWetDirt);
 	bool checkIfPositionOkForAnimal(Vector2D posCircle, float radiusCircle);
+	int getTileCountX() { return tileCountX; }
+	int getTileCountY() { return tileCountY; }
+	int getChunkCountX() { return chunkCountX; }
+	int getChunkCountY() { return chunkCountY; }
+	SDL_Rect computeChunkRectTiles(int chunkIndex);
+	bool checkIfChunkAllocated(int chunkIndex) { return (listChunks[chunkIndex] != nullptr); }
+	SDL_Color computeTileColor(int x, int y) { return getTile(x, y).computeColor(x, y); }
+	int getWetDistance() { return wetDistance; }
+	void setWetDistance(int setWetDistance);
+	int countWetTilesInRect(SDL_Rect rectTiles);
+	int countChunksAllocated();
+	void refreshAllShadowMasks();
+
+	void setPlantIDForTiles(SDL_Rect rectTiles, int plantID);
+	int getPlantIDForTile(int x, int y);
+	bool checkIfTilesFreeOfPlants(SDL_Rect rectTiles);
 
 
 private:
-	std::vector<Tile> listTiles;
+	bool checkIfInBounds(int x, int y) {
+		return (x > -1 && x < tileCountX && y > -1 && y < tileCountY); }
+	int computeChunkIndex(int x, int y) {
+		return (x / LevelChunk::size) + (y / LevelChunk::size) * chunkCountX; }
+	static int computeIndexInChunk(int x, int y) {
+		return (x % LevelChunk::size) + (y % LevelChunk::size) * LevelChunk::size; }
+	const Tile& getTile(int x, int y);
+	Tile& getTileForWrite(int x, int y);
+	LevelChunk& getChunkForWrite(int chunkIndex);
+
+	void placeTileTypeIDSelectedInList(std::vector<int>& listTileIndices);
+	void addCircleToList(Vector2D posCenter, float radius, std::vector<int>& listTileIndicesOut);
+	void refreshShadowMask(int x, int y);
+	Uint8 computeShadowMask(int x, int y);
+	void addToWaterCountsAround(int x, int y, int amount);
+	void setWaterCountForTile(int x, int y, int waterCount);
+	void refreshAllWaterCounts();
+	void refreshWaterCountsInChunk(int chunkIndex);
+	void refreshTableWetInChunk(int chunkIndex);
+	static void buildSummedAreaTable(const std::vector<Uint8>& listValues, int countX, int countY,
+		std::vector<int>& listTableOut);
+	static int sumSummedAreaTable(const std::vector<int>& listTable, int countX, int countY,
+		SDL_Rect rect);
+	void markTileDirty(int x, int y, Uint8 flags);
+	void addChunkToDirtyLists(int chunkIndex, Uint8 flags);
+	void removeCleanChunksFromDirtyList(int flagIndex);
+	static int computeDirtyFlagIndex(Uint8 flag);
+
+	//Call function(x, y) for each tile inside rectTiles with the flag set, then clear the flag on
+	//every tile.
+	template <typename Function>
+	void takeTilesDirtyEach(Uint8 flag, SDL_Rect rectTiles, Function function);
+
+
 	const int tileCountX, tileCountY;
+	const int chunkCountX, chunkCountY;
+	std::vector<std::unique_ptr<LevelChunk>> listChunks;
+	//What the tiles in an unallocated chunk read as.
+	const Tile tileDefault;
+
+	//The dirty flags that apply to every tile in each chunk, e.g. after markTilesDirtyInRect.  Each
+	//flag has it's own list of the chunks that have any tiles with it set, so that taking one flag
+	//doesn't visit the chunks that are only dirty for the others, e.g. for drawing when there's
+	//no renderer.  The lists are indexed by the flag's bit, and each chunk stores which lists it's
+	//in the same way.
+	std::vector<Uint8> listChunkDirtyFlagsAllTiles;
+	std::vector<Uint8> listChunkDirtyListFlags;
+	std::array<std::vector<int>, dirtyFlagCount> listChunkIndicesDirtyByFlag;
+
+	//How far the water spreads.  It's limited so that the number of tiles within it, which could
+	//all be water, always fits in a tile's water count.
+	int wetDistance = 2;
+	static const int wetDistanceMax = 127;
+	static_assert((wetDistanceMax * 2 + 1) * (wetDistanceMax * 2 + 1) <= Tile::waterCountMax,
+		"The water counts could overflow at wetDistanceMax.");
 
 	int tileTypeIDSelected = 0;
-};
\ No newline at end of file
+	//Reused between edits so that they don't need to allocate.
+	std::vector<int> listTileIndicesEdit, listTileIndicesChanged, listTileIndicesWaterChanged,
+		listTileIndicesShadows;
+	//Marks the tiles visited by a flood fill.  It's allocated by the first fill and only the tiles
+	//that were marked are cleared afterwards, so each fill only costs as much as the area it visits.
+	std::vector<bool> listTileVisited;
+	std::vector<int> listTileIndicesToVisit;
+	//A flood fill bigger than this is refused, e.g. one over the untouched ground of a large level,
+	//since every chunk it covers would have to be allocated.
+	const int floodFillTileCountMax = 1 << 20;
+	std::vector<Uint8> listWindowIsWater;
+	std::vector<int> listWindowTableWater;
+	std::vector<Uint8> listChunkIsWet;
+};
+
+
+
+template <typename Function>
+void Level::takeTilesDirtyEach(Uint8 flag, SDL_Rect rectTiles, Function function) {
+	int flagIndex = computeDirtyFlagIndex(flag);
+	for (int chunkIndex : listChunkIndicesDirtyByFlag[flagIndex]) {
+		LevelChunk* chunk = listChunks[chunkIndex].get();
+
+		if (listChunkDirtyFlagsAllTiles[chunkIndex] & flag) {
+			//Every tile in the chunk has the flag, so only visit the ones inside rectTiles.
+			listChunkDirtyFlagsAllTiles[chunkIndex] &= ~flag;
+			if (chunk != nullptr)
+				for (int indexInChunk : chunk->listTileIndicesDirty)
+					chunk->listTileDirtyFlags[indexInChunk] &= ~flag;
+
+			SDL_Rect rectChunk = computeChunkRectTiles(chunkIndex);
+			for (int y = std::max(rectChunk.y, rectTiles.y);
+				y < std::min(rectChunk.y + rectChunk.h, rectTiles.y + rectTiles.h); y++)
+				for (int x = std::max(rectChunk.x, rectTiles.x);
+					x < std::min(rectChunk.x + rectChunk.w, rectTiles.x + rectTiles.w); x++)
+					function(x, y);
+		}
+		else if (chunk != nullptr) {
+			int xChunk = (chunkIndex % chunkCountX) * LevelChunk::size;
+			int yChunk = (chunkIndex / chunkCountX) * LevelChunk::size;
+			for (int indexInChunk : chunk->listTileIndicesDirty) {
+				if (chunk->listTileDirtyFlags[indexInChunk] & flag) {
+					chunk->listTileDirtyFlags[indexInChunk] &= ~flag;
+					int x = xChunk + indexInChunk % LevelChunk::size;
+					int y = yChunk + indexInChunk / LevelChunk::size;
+					if (x >= rectTiles.x && x < rectTiles.x + rectTiles.w &&
+						y >= rectTiles.y && y < rectTiles.y + rectTiles.h)
+						function(x, y);
+				}
+			}
+		}
+	}
+
+	removeCleanChunksFromDirtyList(flagIndex);
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include "LevelChunk.h"
+
+
+//Defined here as well so that they can be passed by reference, e.g. to std::min.
+const int LevelChunk::size;
+const int LevelChunk::tileCount;
+
+
+
+
+LevelChunk::LevelChunk() {
+	listPlantIDs.fill(-1);
+	listTileDirtyFlags.fill(0);
+}
\ No newline at end of file
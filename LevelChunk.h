@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <array>
+#include "SDL2/SDL.h"
+#include "Tile.h"
+
+
+
+//A square block of tiles in a Level along with the layers stored for each tile.  Chunks are only
+//allocated when something in them is changed, so untouched parts of a large level use no memory.
+class LevelChunk
+{
+public:
+	static const int size = 32;
+	static const int tileCount = size * size;
+
+
+	LevelChunk();
+
+
+	std::array<Tile, tileCount> listTiles;
+	//The plant that covers each tile or -1 if there isn't one.
+	std::array<int, tileCount> listPlantIDs;
+	//The dirty flags for each tile, and the indices in this chunk of the tiles with any flags set.
+	std::array<Uint8, tileCount> listTileDirtyFlags;
+	std::vector<int> listTileIndicesDirty;
+
+	//Totals for the chunk so that whole chunks can be skipped by queries.
+	int waterTileCount = 0;
+	int wetTileCount = 0;
+	int plantTileCount = 0;
+
+	//A summed area table of the wet tiles, used to count them in part of the chunk.  It's only
+	//built when it's needed after their wetness changed.
+	std::vector<int> listTableWet;
+	bool tableWetIsDirty = true;
+};
\ No newline at end of file
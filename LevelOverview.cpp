@@ -0,0 +1,261 @@
+#include "LevelOverview.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+LevelOverview::LevelOverview(int setChunkCountX, int setChunkCountY) :
+	chunkCountX(setChunkCountX), chunkCountY(setChunkCountY) {
+	size_t chunkCount = (size_t)chunkCountX * chunkCountY;
+	listChunkImages.resize(chunkCount);
+	listPixelsLevel.assign(chunkCount, 0);
+	listPixelsChunk.resize(LevelChunk::tileCount);
+}
+
+
+LevelOverview::~LevelOverview() {
+	//Clean up.
+	for (auto& chunkImageSelected : listChunkImages) {
+		if (chunkImageSelected.texture != nullptr) {
+			SDL_DestroyTexture(chunkImageSelected.texture);
+			chunkImageSelected.texture = nullptr;
+		}
+	}
+
+	if (textureChunkDefault != nullptr) {
+		SDL_DestroyTexture(textureChunkDefault);
+		textureChunkDefault = nullptr;
+	}
+
+	if (textureLevel != nullptr) {
+		SDL_DestroyTexture(textureLevel);
+		textureLevel = nullptr;
+	}
+}
+
+
+
+void LevelOverview::refresh(Level& level) {
+	//Called every frame, even when the overview isn't drawn, so that the level doesn't keep the
+	//flags around.  The images are only rebuilt when they're next drawn.
+	listChunkIndicesDirty.clear();
+	level.takeChunksDirty(Level::dirtyOverview, listChunkIndicesDirty);
+	for (int chunkIndex : listChunkIndicesDirty) {
+		listChunkImages[chunkIndex].textureStale = true;
+		listChunkImages[chunkIndex].averageStale = true;
+	}
+}
+
+
+
+void LevelOverview::draw(SDL_Renderer* renderer, World& world, const Camera& camera) {
+	Level& level = world.getLevel();
+	SDL_Rect rectTilesVisible = camera.computeRectTilesVisible(level.getTileCountX(), level.getTileCountY());
+
+	if (camera.getZoom() < zoomMaxLevel)
+		drawLevel(renderer, world, camera);
+	else {
+		int chunkLeft = rectTilesVisible.x / LevelChunk::size;
+		int chunkTop = rectTilesVisible.y / LevelChunk::size;
+		int chunkRight = (rectTilesVisible.x + rectTilesVisible.w + LevelChunk::size - 1) / LevelChunk::size;
+		int chunkBottom = (rectTilesVisible.y + rectTilesVisible.h + LevelChunk::size - 1) / LevelChunk::size;
+		drawChunks(renderer, world, camera,
+			SDL_Rect{ chunkLeft, chunkTop, chunkRight - chunkLeft, chunkBottom - chunkTop });
+	}
+
+	drawAnimals(renderer, world, camera, rectTilesVisible);
+}
+
+
+void LevelOverview::drawChunks(SDL_Renderer* renderer, World& world, const Camera& camera,
+	SDL_Rect rectChunksVisible) {
+	Level& level = world.getLevel();
+
+	for (int yChunk = rectChunksVisible.y; yChunk < rectChunksVisible.y + rectChunksVisible.h; yChunk++) {
+		for (int xChunk = rectChunksVisible.x; xChunk < rectChunksVisible.x + rectChunksVisible.w; xChunk++) {
+			int chunkIndex = xChunk + yChunk * chunkCountX;
+			ChunkImage& chunkImageSelected = listChunkImages[chunkIndex];
+			SDL_Rect rectChunk = level.computeChunkRectTiles(chunkIndex);
+
+			SDL_Texture* textureSelected = nullptr;
+			if (level.checkIfChunkAllocated(chunkIndex)) {
+				if (chunkImageSelected.texture == nullptr) {
+					chunkImageSelected.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
+						SDL_TEXTUREACCESS_STATIC, LevelChunk::size, LevelChunk::size);
+					chunkImageSelected.textureStale = true;
+				}
+
+				if (chunkImageSelected.textureStale) {
+					bakeChunk(world, chunkIndex);
+					SDL_UpdateTexture(chunkImageSelected.texture, NULL, listPixelsChunk.data(),
+						LevelChunk::size * sizeof(Uint32));
+					chunkImageSelected.textureStale = false;
+				}
+				textureSelected = chunkImageSelected.texture;
+			}
+			else {
+				bakeChunkDefault(renderer);
+				textureSelected = textureChunkDefault;
+			}
+
+			//Chunks on the right and bottom edges can be cut off by the edge of the level.
+			SDL_Rect rectSource = { 0, 0, rectChunk.w, rectChunk.h };
+			SDL_Rect rectScreen = computeRectScreenForTiles(camera, rectChunk);
+			SDL_RenderCopy(renderer, textureSelected, &rectSource, &rectScreen);
+		}
+	}
+}
+
+
+void LevelOverview::drawLevel(SDL_Renderer* renderer, World& world, const Camera& camera) {
+	Level& level = world.getLevel();
+
+	if (textureLevel == nullptr) {
+		textureLevel = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
+			SDL_TEXTUREACCESS_STATIC, chunkCountX, chunkCountY);
+		textureLevelStale = true;
+	}
+
+	//Only the pixels of the chunks that changed are worked out again.
+	bakeChunkDefault(renderer);
+	for (int chunkIndex = 0; chunkIndex < (int)listChunkImages.size(); chunkIndex++) {
+		ChunkImage& chunkImageSelected = listChunkImages[chunkIndex];
+		if (chunkImageSelected.averageStale) {
+			if (level.checkIfChunkAllocated(chunkIndex))
+				bakeChunk(world, chunkIndex);
+			else {
+				listPixelsLevel[chunkIndex] = pixelChunkDefault;
+				chunkImageSelected.averageStale = false;
+				textureLevelStale = true;
+			}
+		}
+	}
+
+	if (textureLevelStale) {
+		SDL_UpdateTexture(textureLevel, NULL, listPixelsLevel.data(), chunkCountX * sizeof(Uint32));
+		textureLevelStale = false;
+	}
+
+	//Chunks cut off by the edge of the level are stretched slightly, which can't be seen this far out.
+	SDL_Rect rectScreen = computeRectScreenForTiles(camera,
+		SDL_Rect{ 0, 0, level.getTileCountX(), level.getTileCountY() });
+	SDL_RenderCopy(renderer, textureLevel, NULL, &rectScreen);
+}
+
+
+void LevelOverview::drawAnimals(SDL_Renderer* renderer, World& world, const Camera& camera,
+	SDL_Rect rectTilesVisible) {
+	//Draw each animal as a square dot in it's type's color.  The dots are grouped by type so that
+	//each type only needs one draw call.
+	for (auto& listRectsSelected : listRectsAnimalsByType)
+		listRectsSelected.clear();
+
+	//Only look at the animals the grid has near the view, and then only draw the ones inside it.
+	AnimalStore& animals = world.getAnimals();
+	float pixelsPerTile = camera.getTileSize() * camera.getZoom();
+	Vector2D posVisibleMin((float)rectTilesVisible.x, (float)rectTilesVisible.y);
+	Vector2D posVisibleMax((float)(rectTilesVisible.x + rectTilesVisible.w),
+		(float)(rectTilesVisible.y + rectTilesVisible.h));
+	for (int index : world.queryAnimalsInRect(posVisibleMin, posVisibleMax)) {
+		Vector2D pos = animals.listPos[index];
+		if (pos.x >= rectTilesVisible.x && pos.x < rectTilesVisible.x + rectTilesVisible.w &&
+			pos.y >= rectTilesVisible.y && pos.y < rectTilesVisible.y + rectTilesVisible.h) {
+			int typeID = animals.listTypeID[index];
+			if (typeID >= (int)listRectsAnimalsByType.size())
+				listRectsAnimalsByType.resize(typeID + 1);
+
+			int size = std::max((int)std::round(Animal::computeRadius(typeID) * 2.0f * pixelsPerTile), 2);
+			Vector2D posScreen = camera.convertWorldToScreen(pos);
+			listRectsAnimalsByType[typeID].push_back(SDL_Rect{
+				(int)std::round(posScreen.x) - size / 2, (int)std::round(posScreen.y) - size / 2, size, size });
+		}
+	}
+
+	for (int typeID = 0; typeID < (int)listRectsAnimalsByType.size(); typeID++) {
+		std::vector<SDL_Rect>& listRectsSelected = listRectsAnimalsByType[typeID];
+		if (listRectsSelected.empty() == false) {
+			SDL_Color colorSelected = Animal::getColorOverview(typeID);
+			SDL_SetRenderDrawColor(renderer, colorSelected.r, colorSelected.g, colorSelected.b, 255);
+			SDL_RenderFillRects(renderer, listRectsSelected.data(), (int)listRectsSelected.size());
+		}
+	}
+}
+
+
+
+void LevelOverview::bakeChunk(World& world, int chunkIndex) {
+	//Work out the chunk's pixels, with any plant drawn over the tile it covers, and the average of
+	//them for the chunk's pixel in the level image.
+	Level& level = world.getLevel();
+	PlantStore& plants = world.getPlants();
+	SDL_Rect rectChunk = level.computeChunkRectTiles(chunkIndex);
+
+	std::fill(listPixelsChunk.begin(), listPixelsChunk.end(), 0);
+	int sumR = 0, sumG = 0, sumB = 0;
+	for (int y = 0; y < rectChunk.h; y++) {
+		for (int x = 0; x < rectChunk.w; x++) {
+			int xTile = rectChunk.x + x, yTile = rectChunk.y + y;
+			SDL_Color colorSelected;
+			int plantSlot = level.getPlantIDForTile(xTile, yTile);
+			if (plantSlot != -1)
+				colorSelected = Plant::getColorOverview(
+					plants.listTypeID[plants.slots.getIndexForSlot(plantSlot)]);
+			else
+				colorSelected = level.computeTileColor(xTile, yTile);
+
+			listPixelsChunk[x + y * LevelChunk::size] = convertColorToPixel(colorSelected);
+			sumR += colorSelected.r;
+			sumG += colorSelected.g;
+			sumB += colorSelected.b;
+		}
+	}
+
+	int tileCount = std::max(rectChunk.w * rectChunk.h, 1);
+	listPixelsLevel[chunkIndex] = convertColorToPixel(SDL_Color{
+		(Uint8)(sumR / tileCount), (Uint8)(sumG / tileCount), (Uint8)(sumB / tileCount), 255 });
+	listChunkImages[chunkIndex].averageStale = false;
+	textureLevelStale = true;
+}
+
+
+void LevelOverview::bakeChunkDefault(SDL_Renderer* renderer) {
+	//Build the image shared by every unallocated chunk the first time it's needed.  The chunk size
+	//is even so the checkered pattern lines up the same way in every chunk.
+	if (textureChunkDefault != nullptr)
+		return;
+
+	const Tile tileDefault;
+	int sumR = 0, sumG = 0, sumB = 0;
+	for (int y = 0; y < LevelChunk::size; y++) {
+		for (int x = 0; x < LevelChunk::size; x++) {
+			SDL_Color colorSelected = tileDefault.computeColor(x, y);
+			listPixelsChunk[x + y * LevelChunk::size] = convertColorToPixel(colorSelected);
+			sumR += colorSelected.r;
+			sumG += colorSelected.g;
+			sumB += colorSelected.b;
+		}
+	}
+
+	textureChunkDefault = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
+		SDL_TEXTUREACCESS_STATIC, LevelChunk::size, LevelChunk::size);
+	SDL_UpdateTexture(textureChunkDefault, NULL, listPixelsChunk.data(), LevelChunk::size * sizeof(Uint32));
+	pixelChunkDefault = convertColorToPixel(SDL_Color{ (Uint8)(sumR / LevelChunk::tileCount),
+		(Uint8)(sumG / LevelChunk::tileCount), (Uint8)(sumB / LevelChunk::tileCount), 255 });
+}
+
+
+Uint32 LevelOverview::convertColorToPixel(SDL_Color color) {
+	//Packed to match SDL_PIXELFORMAT_ABGR8888, which has red in the lowest bits.
+	return ((Uint32)color.a << 24) | ((Uint32)color.b << 16) | ((Uint32)color.g << 8) | (Uint32)color.r;
+}
+
+
+SDL_Rect LevelOverview::computeRectScreenForTiles(const Camera& camera, SDL_Rect rectTiles) {
+	//Use the same rounding as the individual tiles so that neighbouring images meet without gaps.
+	SDL_Rect rectTopLeft = camera.computeRectScreenForTile(rectTiles.x, rectTiles.y);
+	SDL_Rect rectBottomRight = camera.computeRectScreenForTile(
+		rectTiles.x + rectTiles.w - 1, rectTiles.y + rectTiles.h - 1);
+	return SDL_Rect{ rectTopLeft.x, rectTopLeft.y,
+		rectBottomRight.x + rectBottomRight.w - rectTopLeft.x,
+		rectBottomRight.y + rectBottomRight.h - rectTopLeft.y };
+}
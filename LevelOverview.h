@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include "SDL2/SDL.h"
+#include "World.h"
+#include "Camera.h"
+
+
+
+//Draws the level when the camera is zoomed too far out for the tiles and textures to be worth
+//drawing one by one.  Each chunk is drawn as a single small image with a pixel per tile and the
+//plants baked into it as dots of color, and further out the whole level is drawn as one image
+//with a pixel per chunk.  The images are only rebuilt for the chunks that changed.
+class LevelOverview
+{
+public:
+	LevelOverview(int setChunkCountX, int setChunkCountY);
+	~LevelOverview();
+	void refresh(Level& level);
+	bool checkIfUsedAtZoom(float zoom) { return (zoom < zoomMaxChunks); }
+	void draw(SDL_Renderer* renderer, World& world, const Camera& camera);
+
+
+private:
+	struct ChunkImage {
+		SDL_Texture* texture = nullptr;
+		//Whether the texture or the chunk's pixel in the level image need to be rebuilt.
+		bool textureStale = true, averageStale = true;
+	};
+
+
+	void drawChunks(SDL_Renderer* renderer, World& world, const Camera& camera, SDL_Rect rectChunksVisible);
+	void drawLevel(SDL_Renderer* renderer, World& world, const Camera& camera);
+	void drawAnimals(SDL_Renderer* renderer, World& world, const Camera& camera, SDL_Rect rectTilesVisible);
+	void bakeChunk(World& world, int chunkIndex);
+	void bakeChunkDefault(SDL_Renderer* renderer);
+	static Uint32 convertColorToPixel(SDL_Color color);
+	static SDL_Rect computeRectScreenForTiles(const Camera& camera, SDL_Rect rectTiles);
+
+
+	//Below this zoom each chunk is drawn as one image, and below zoomMaxLevel the whole level is.
+	const float zoomMaxChunks = 0.25f, zoomMaxLevel = 1.0f / 128.0f;
+
+	const int chunkCountX, chunkCountY;
+	std::vector<ChunkImage> listChunkImages;
+
+	//Every unallocated chunk looks the same so they share one texture.
+	SDL_Texture* textureChunkDefault = nullptr;
+	Uint32 pixelChunkDefault = 0;
+
+	//The whole level with a pixel per chunk, and whether it needs to be uploaded again.
+	SDL_Texture* textureLevel = nullptr;
+	std::vector<Uint32> listPixelsLevel;
+	bool textureLevelStale = true;
+
+	//Reused between frames so that they don't need to allocate.
+	std::vector<Uint32> listPixelsChunk;
+	std::vector<int> listChunkIndicesDirty;
+	std::vector<std::vector<SDL_Rect>> listRectsAnimalsByType;
+};
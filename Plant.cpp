@@ -1,129 +1,140 @@
 #include "Plant.h"
-#include "Game.h"
+#include "World.h"
 
 
 const std::vector<Plant::Type> Plant::listPlantTypes = {
-	{ "Plant 1", 1, true },
-	{ "Plant 2", 1, true },
-	{ "Plant 3", 1, false },
-	{ "Plant 4", 2, false },
-	{ "Plant 5", 2, false }
+	{ "Plant 1", 1, true, { 96, 176, 64, 255 } },
+	{ "Plant 2", 1, true, { 224, 200, 72, 255 } },
+	{ "Plant 3", 1, false, { 40, 132, 56, 255 } },
+	{ "Plant 4", 2, false, { 20, 96, 40, 255 } },
+	{ "Plant 5", 2, false, { 150, 210, 90, 255 } }
 };
+std::vector<Plant::TypeSprites> Plant::listTypeSprites;
 
+const float Plant::drawScaleMin = 0.95f;
+ScaledSpriteCache Plant::scaledSpriteCache(drawScaleMin, 1.0f, 8);
 
 
 
-Plant::Plant(SDL_Renderer* renderer, int setTypeID, Vector2D setPos) :
-	typeID(setTypeID), pos(setPos), timerGrowth(7.5f + MathAddon::randFloat() * 7.5f),
-	timerMoveUpAndDown(2.0f, MathAddon::randFloat() * 2.0f) {
-
-	if (setTypeID > -1 && setTypeID < listPlantTypes.size()) {
-		std::string name = listPlantTypes[setTypeID].name;
-		textureSmallMain = TextureLoader::loadTexture(renderer, name + " Small.bmp");
-		textureSmallShadow = TextureLoader::loadTexture(renderer, name + " Small Shadow.bmp");
-		textureMain = TextureLoader::loadTexture(renderer, name + ".bmp");
-		textureShadow = TextureLoader::loadTexture(renderer, name + " Shadow.bmp");
 
+int Plant::add(PlantStore& plants, int plantTypeID, Vector2D pos) {
+	//Add a plant of the input type and return it's index, or -1 if the type doesn't exist.
+	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size()) {
 		//Offset the plant's position based on it's size.
-		pos += computeOffset(setTypeID);
+		return plants.add((Uint8)plantTypeID, pos + computeOffset(plantTypeID),
+			Timer(7.5f + MathAddon::randFloat() * 7.5f),
+			Timer(2.0f, MathAddon::randFloat() * 2.0f));
 	}
+
+	return -1;
 }
 
 
 
-void Plant::update(float dT) {
-	//Grow plant if needed.
-	timerGrowth.countUp(dT);
+void Plant::updateAll(PlantStore& plants, float dT) {
+	//Store the previous draw scales so that they can be interpolated between ticks.
+	plants.listDrawScalePrevious = plants.listDrawScale;
+
+	//Grow the plants if needed.
+	for (auto& timerGrowth : plants.listTimerGrowth)
+		timerGrowth.countUp(dT);
 
 
-	//Update the scale that this is drawn to make it appear like it's moving up and down.
-	timerMoveUpAndDown.countUp(dT);
-	if (timerMoveUpAndDown.timeSIsMax())
-		timerMoveUpAndDown.resetToZero();
+	//Update the scale that each plant is drawn to make it appear like it's moving up and down.
+	for (int index = 0; index < plants.size(); index++) {
+		Timer& timerMoveUpAndDown = plants.listTimerMoveUpAndDown[index];
+		timerMoveUpAndDown.countUp(dT);
+		if (timerMoveUpAndDown.timeSIsMax())
+			timerMoveUpAndDown.resetToZero();
 
-	//Compute the draw scale by using a cosine wave and the timer's time.
-	float fDrawScaleMin = 0.95f;
-	float fCos = (cos(timerMoveUpAndDown.computeFTime() * 2.0f * MathAddon::PI) + 1.0f) / 2.0f;
-	fDrawScale = fDrawScaleMin + (1.0f - fDrawScaleMin) * fCos;
+		//Compute the draw scale by using a cosine wave and the timer's time.
+		float fCos = (cos(timerMoveUpAndDown.computeFTime() * 2.0f * MathAddon::PI) + 1.0f) / 2.0f;
+		plants.listDrawScale[index] = drawScaleMin + (1.0f - drawScaleMin) * fCos;
+	}
 }
 
 
 
-void Plant::draw(SDL_Renderer* renderer, int tileSize) {
-	if (timerGrowth.timeSIsMax())
-		//Fully grown.
-		drawTexture(renderer, textureMain, tileSize);
-	else
-		//Still growing.
-		drawTexture(renderer, textureSmallMain, tileSize);
+void Plant::registerSpriteAssets() {
+	//Resolve each type's images to asset ids once, so that drawing only has to index arrays.
+	if (listTypeSprites.empty()) {
+		for (const auto& typeSelected : listPlantTypes) {
+			TypeSprites typeSpritesAdded;
+			typeSpritesAdded.assetIDSmallMain = TextureLoader::registerAsset(typeSelected.name + " Small.bmp");
+			typeSpritesAdded.assetIDSmallShadow = TextureLoader::registerAsset(typeSelected.name + " Small Shadow.bmp");
+			typeSpritesAdded.assetIDMain = TextureLoader::registerAsset(typeSelected.name + ".bmp");
+			typeSpritesAdded.assetIDShadow = TextureLoader::registerAsset(typeSelected.name + " Shadow.bmp");
+			listTypeSprites.push_back(typeSpritesAdded);
+		}
+	}
 }
 
 
-void Plant::drawShadow(SDL_Renderer* renderer, int tileSize) {
-	if (timerGrowth.timeSIsMax())
+const Plant::TypeSprites& Plant::loadSprites(SDL_Renderer* renderer, int plantTypeID) {
+	//The sprites are only needed for drawing so load them the first time the type is drawn.  They
+	//decode in the background and draw as placeholders until then, so keep asking until each one
+	//has either loaded or failed.
+	registerSpriteAssets();
+	TypeSprites& sprites = listTypeSprites[plantTypeID];
+	if (sprites.main.checkIfResolved() == false || sprites.smallMain.checkIfResolved() == false ||
+		sprites.shadow.checkIfResolved() == false || sprites.smallShadow.checkIfResolved() == false) {
+		sprites.smallMain = TextureLoader::requestSprite(renderer, sprites.assetIDSmallMain);
+		sprites.smallShadow = TextureLoader::requestSprite(renderer, sprites.assetIDSmallShadow);
+		sprites.main = TextureLoader::requestSprite(renderer, sprites.assetIDMain);
+		sprites.shadow = TextureLoader::requestSprite(renderer, sprites.assetIDShadow);
+	}
+
+	return sprites;
+}
+
+
+void Plant::draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, PlantStore& plants, int index,
+	const Camera& camera, float alpha) {
+	const TypeSprites& sprites = loadSprites(renderer, plants.listTypeID[index]);
+	if (plants.listTimerGrowth[index].timeSIsMax())
 		//Fully grown.
-		drawTexture(renderer, textureShadow, tileSize);
+		drawSprite(renderer, spriteBatch, plants, index, sprites.main, camera, alpha, 255);
 	else
 		//Still growing.
-		drawTexture(renderer, textureSmallShadow, tileSize);
+		drawSprite(renderer, spriteBatch, plants, index, sprites.smallMain, camera, alpha, 255);
 }
 
 
-void Plant::drawTexture(SDL_Renderer* renderer, SDL_Texture* textureSelected, int tileSize) {
-	if (renderer != nullptr && textureSelected != nullptr) {
-		int w, h;
-		SDL_QueryTexture(textureSelected, NULL, NULL, &w, &h);
-
-		w = (int)round(w * fDrawScale);
-		h = (int)round(h * fDrawScale);
-
-		SDL_Rect rect = {
-			(int)round(pos.x * tileSize) - w / 2,
-			(int)round(pos.y * tileSize) - h / 2,
-			w,
-			h };
-		SDL_RenderCopy(renderer, textureSelected, NULL, &rect);
-	}
+void Plant::drawShadow(SDL_Renderer* renderer, SpriteBatch& spriteBatch, PlantStore& plants, int index,
+	const Camera& camera, float alpha, Uint8 alphaShadow) {
+	const TypeSprites& sprites = loadSprites(renderer, plants.listTypeID[index]);
+	const Sprite& spriteSelected = (plants.listTimerGrowth[index].timeSIsMax() ?
+		sprites.shadow : sprites.smallShadow);
+	//A placeholder has no shadow.
+	if (spriteSelected.isPlaceholder == false)
+		drawSprite(renderer, spriteBatch, plants, index, spriteSelected, camera, alpha, alphaShadow);
 }
 
 
-
-bool Plant::checkOverlapWithPlantTypeID(int x, int y, int plantTypeID) {
-	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size())
-		return checkOverlap(x, y, listPlantTypes[plantTypeID].size);
-
-	return false;
+void Plant::setScaledSpriteFrameCount(int frameCount) {
+	//Zero turns the cache off so that the sprites are scaled exactly when they're drawn.
+	scaledSpriteCache.setFrameCount(frameCount);
 }
 
 
-bool Plant::checkOverlapWithMouse(int x, int y) {
-	return checkOverlap(x, y, 1);
+void Plant::refreshScaledSprites(SDL_Renderer* renderer) {
+	scaledSpriteCache.refresh(renderer);
 }
 
 
-bool Plant::checkOverlap(int x, int y, int size) {
-	//Setup a rectangle that represents the tiles that this plant overlaps, and
-	//another rectangle that represents the input.  Then check if they overlap.
-
-	if (typeID > -1 && typeID < listPlantTypes.size()) {
-		float offset1 = computeOffset(typeID);
+void Plant::drawSprite(SDL_Renderer* renderer, SpriteBatch& spriteBatch, PlantStore& plants,
+	int index, const Sprite& spriteSelected, const Camera& camera, float alpha, Uint8 alphaMod) {
+	if (renderer != nullptr && spriteSelected.checkIfLoaded()) {
+		//Interpolate the draw scale between the previous and current ticks.
+		float fDrawScale = plants.listDrawScale[index];
+		float fDrawScalePrevious = plants.listDrawScalePrevious[index];
+		float fDrawScaleInterpolated = fDrawScalePrevious + (fDrawScale - fDrawScalePrevious) * alpha;
 
-		int rect1Left = (int)(pos.x - offset1);
-		int rect1Top = (int)(pos.y - offset1);
-		int rect1Right = rect1Left + listPlantTypes[typeID].size - 1;
-		int rect1Bottom = rect1Top + listPlantTypes[typeID].size - 1;
-
-		int rect2Left = x;
-		int rect2Top = y;
-		int rect2Right = rect2Left + size - 1;
-		int rect2Bottom = rect2Top + size - 1;
-
-		//If there is a gap between any of the sides then they don't overlap.
-		return ((rect1Left > rect2Right || rect2Left > rect1Right ||
-			rect1Top > rect2Bottom || rect2Top > rect1Bottom) == false);
+		Vector2D posScreen = camera.convertWorldToScreen(plants.listPos[index]);
+		scaledSpriteCache.draw(renderer, spriteBatch, spriteSelected,
+			SDL_Point{ (int)round(posScreen.x), (int)round(posScreen.y) }, camera.getZoom(),
+			fDrawScaleInterpolated, alphaMod);
 	}
-
-	return false;
 }
 
 
@@ -137,13 +148,9 @@ float Plant::computeOffset(int plantTypeID) {
 
 
 
-bool Plant::checkIfTilesUnderOk(Level& level) {
-	float offset = computeOffset(typeID);
-
-	int x = (int)(pos.x - offset);
-	int y = (int)(pos.y - offset);
-
-	return checkIfTilesUnderOkForType(x, y, typeID, level);
+bool Plant::checkIfTilesUnderOk(PlantStore& plants, int index, Level& level) {
+	SDL_Rect rectTiles = computeRectTiles(plants, index);
+	return checkIfTilesUnderOkForType(rectTiles.x, rectTiles.y, plants.listTypeID[index], level);
 }
 
 
@@ -171,25 +178,26 @@ bool Plant::checkIfTilesUnderOkForType(int x, int y, int plantTypeID, Level& lev
 
 
 
-bool Plant::checkIfPositionOkForType(Vector2D posCheck, int plantTypeID, Game& game) {
+bool Plant::checkIfPositionOkForType(Vector2D posCheck, int plantTypeID, World& world) {
 	//Check if the input position is ok or blocked.
 	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size()) {
 		//Check overlap with the level.
 		if (checkIfTilesUnderOkForType((int)posCheck.x, (int)posCheck.y, plantTypeID, 
-			game.getLevel()) == false)
+			world.getLevel()) == false)
 			return false;
 
 		//Check overlap with animals.
 		Vector2D posCheckWithOffset = posCheck + computeOffset(plantTypeID);
 		float radiusCheck = computeRadius(plantTypeID);
-		for (auto& animalSelected : game.getListAnimals())
-			if (animalSelected.checkCircleOverlap(posCheckWithOffset, radiusCheck))
+		AnimalStore& animals = world.getAnimals();
+		for (int animalID : world.queryAnimals(posCheckWithOffset, radiusCheck))
+			if (Animal::checkCircleOverlap(animals, animalID, posCheckWithOffset, radiusCheck))
 				return false;
 
-		//Check overlap with plants.
-		for (auto& plantSelected : game.getListPlants())
-			if (plantSelected.checkOverlapWithPlantTypeID((int)posCheck.x, (int)posCheck.y, plantTypeID))
-				return false;
+		//Check overlap with plants by looking up the tiles it would cover.
+		if (world.getLevel().checkIfTilesFreeOfPlants(
+			computeRectTilesForType((int)posCheck.x, (int)posCheck.y, plantTypeID)) == false)
+			return false;
 
 		return true;
 	}
@@ -199,17 +207,42 @@ bool Plant::checkIfPositionOkForType(Vector2D posCheck, int plantTypeID, Game& g
 
 
 
-bool Plant::checkCircleOverlap(Vector2D posCircle, float radiusCircle) {
-	if (typeID > -1 && typeID < listPlantTypes.size()) {
-		//For simplicity assume that this plant is bound by a circle at it's position pos,
-		//and radius as follows.
-		return (pos - posCircle).magnitude() <= (computeRadius(typeID) + radiusCircle);
+bool Plant::checkCircleOverlap(PlantStore& plants, int index, Vector2D posCircle, float radiusCircle) {
+	//For simplicity assume that the plant is bound by a circle at it's position, and radius as
+	//follows.
+	return (plants.listPos[index] - posCircle).magnitude() <=
+		(computeRadius(plants.listTypeID[index]) + radiusCircle);
+}
+
+
+
+SDL_Rect Plant::computeRectTiles(PlantStore& plants, int index) {
+	int plantTypeID = plants.listTypeID[index];
+	Vector2D pos = plants.listPos[index];
+	float offset = computeOffset(plantTypeID);
+	return computeRectTilesForType((int)(pos.x - offset), (int)(pos.y - offset), plantTypeID);
+}
+
+
+SDL_Rect Plant::computeRectTilesForType(int x, int y, int plantTypeID) {
+	//The tiles covered by a plant of the input type whose top left tile is x, y.
+	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size()) {
+		int size = listPlantTypes[plantTypeID].size;
+		return SDL_Rect{ x, y, size, size };
 	}
 
-	return false;
+	return SDL_Rect{ x, y, 0, 0 };
 }
 
 
+float Plant::computeRadiusBounding(int plantTypeID) {
+	//The radius of a circle that contains all the tiles that a plant of the input type covers.
+	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size())
+		return listPlantTypes[plantTypeID].size / 2.0f;
+
+	return 0.0f;
+}
+
 
 float Plant::computeRadius(int plantTypeID) {
 	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size())
@@ -217,4 +250,12 @@ float Plant::computeRadius(int plantTypeID) {
 		return (listPlantTypes[plantTypeID].size * 0.80f / 2.0f);
 
 	return 0.0f;
+}
+
+
+SDL_Color Plant::getColorOverview(int plantTypeID) {
+	if (plantTypeID > -1 && plantTypeID < listPlantTypes.size())
+		return listPlantTypes[plantTypeID].colorOverview;
+
+	return SDL_Color{ 0, 0, 0, 255 };
 }
\ No newline at end of file
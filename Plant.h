@@ -6,10 +6,15 @@
 #include "Timer.h"
 #include "MathAddon.h"
 #include "Level.h"
-class Game;
+#include "Camera.h"
+#include "PlantStore.h"
+#include "ScaledSpriteCache.h"
+class World;
 
 
 
+//The rules for how plants behave and are drawn.  The plants themselves are stored in a PlantStore
+//and identified by their index into it.
 class Plant
 {
 private:
@@ -17,37 +22,53 @@ private:
 		std::string name = "";
 		int size = 1;
 		bool growsOnWetDirt = true;
+		//Used instead of the textures when the camera is zoomed far out.
+		SDL_Color colorOverview = { 0, 0, 0, 255 };
+	};
+
+	//What every plant of a type is drawn with, shared by all of them instead of stored per plant.
+	//The asset ids are resolved once at startup so that the sprites can be looked up without
+	//building filenames, and the sprites are filled in the first time the type is drawn.
+	struct TypeSprites {
+		int assetIDSmallMain = -1, assetIDSmallShadow = -1, assetIDMain = -1, assetIDShadow = -1;
+		Sprite smallMain, smallShadow, main, shadow;
 	};
 
 
 public:
-	Plant(SDL_Renderer* renderer, int setTypeID, Vector2D setPos);
-	void update(float dT);
-	void draw(SDL_Renderer* renderer, int tileSize);
-	void drawShadow(SDL_Renderer* renderer, int tileSize);
-	bool checkOverlapWithPlantTypeID(int x, int y, int plantTypeID);
-	bool checkOverlapWithMouse(int x, int y);
-	bool checkIfTilesUnderOk(Level& level);
+	static int add(PlantStore& plants, int plantTypeID, Vector2D pos);
+	static void updateAll(PlantStore& plants, float dT);
+	static void draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, PlantStore& plants, int index,
+		const Camera& camera, float alpha);
+	static void drawShadow(SDL_Renderer* renderer, SpriteBatch& spriteBatch, PlantStore& plants, int index,
+		const Camera& camera, float alpha, Uint8 alphaShadow);
+	static bool checkIfTilesUnderOk(PlantStore& plants, int index, Level& level);
 	static bool checkIfTilesUnderOkForType(int x, int y, int plantTypeID, Level& level);
-	static bool checkIfPositionOkForType(Vector2D posCheck, int plantTypeID, Game& game);
-	bool checkCircleOverlap(Vector2D posCircle, float radiusCircle);
+	static bool checkIfPositionOkForType(Vector2D posCheck, int plantTypeID, World& world);
+	static bool checkCircleOverlap(PlantStore& plants, int index, Vector2D posCircle, float radiusCircle);
+	static float computeRadiusBounding(int plantTypeID);
+	static SDL_Rect computeRectTiles(PlantStore& plants, int index);
+	static SDL_Rect computeRectTilesForType(int x, int y, int plantTypeID);
+	static SDL_Color getColorOverview(int plantTypeID);
+	static void setScaledSpriteFrameCount(int frameCount);
+	static void refreshScaledSprites(SDL_Renderer* renderer);
+	static void registerSpriteAssets();
 
 
 private:
-	void drawTexture(SDL_Renderer* renderer, SDL_Texture* textureSelected, int tileSize);
-	bool checkOverlap(int x, int y, int size);
+	static const TypeSprites& loadSprites(SDL_Renderer* renderer, int plantTypeID);
+	static void drawSprite(SDL_Renderer* renderer, SpriteBatch& spriteBatch, PlantStore& plants,
+		int index, const Sprite& spriteSelected, const Camera& camera, float alpha, Uint8 alphaMod);
 	static float computeOffset(int plantTypeID);
 	static float computeRadius(int plantTypeID);
 
 
-	Vector2D pos;
-	float fDrawScale = 1.0f;
-	Timer timerGrowth, timerMoveUpAndDown;
-
-	int typeID;
-
-	SDL_Texture* textureSmallMain = nullptr, * textureSmallShadow = nullptr,
-		* textureMain = nullptr, * textureShadow = nullptr;
-
 	static const std::vector<Type> listPlantTypes;
+	//Indexed by type id, and filled in by registerSpriteAssets.
+	static std::vector<TypeSprites> listTypeSprites;
+
+	//How small the plants get as they move up and down, and the textures pre-rendered at the
+	//scales in between.
+	static const float drawScaleMin;
+	static ScaledSpriteCache scaledSpriteCache;
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "PlantStore.h"
+
+
+
+int PlantStore::add(Uint8 typeID, Vector2D pos, Timer timerGrowth, Timer timerMoveUpAndDown) {
+	listTypeID.push_back(typeID);
+	listPos.push_back(pos);
+	listTimerGrowth.push_back(timerGrowth);
+	listTimerMoveUpAndDown.push_back(timerMoveUpAndDown);
+	listDrawScale.push_back(1.0f);
+	listDrawScalePrevious.push_back(1.0f);
+
+	slots.add();
+
+	return size() - 1;
+}
+
+
+void PlantStore::erase(int index) {
+	//Move the last plant into the hole so nothing else has to shift.
+	slots.eraseSwapWithLast(index);
+	SlotMap::swapAndPop(listTypeID, index);
+	SlotMap::swapAndPop(listPos, index);
+	SlotMap::swapAndPop(listTimerGrowth, index);
+	SlotMap::swapAndPop(listTimerMoveUpAndDown, index);
+	SlotMap::swapAndPop(listDrawScale, index);
+	SlotMap::swapAndPop(listDrawScalePrevious, index);
+}
+
+
+void PlantStore::eraseQueued() {
+	//The slots stay valid while other plants are erased, so use them to find each index.
+	std::vector<int>& listSlots = slots.getListSlotsEraseQueued();
+	for (int slot : listSlots)
+		erase(slots.getIndexForSlot(slot));
+	listSlots.clear();
+}
\ No newline at end of file
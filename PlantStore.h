@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "SDL2/SDL.h"
+#include "Vector2D.h"
+#include "Timer.h"
+#include "SlotMap.h"
+#include "StoreColumns.h"
+
+
+
+//The data for every plant, stored as one contiguous array per field so that each system only
+//touches the fields that it needs.  A plant is identified by it's index into the arrays, which
+//can change when another plant is erased, or by it's slot, which can't.
+class PlantStore
+{
+public:
+	int add(Uint8 typeID, Vector2D pos, Timer timerGrowth, Timer timerMoveUpAndDown);
+	void erase(int index);
+	void queueErase(int index) { slots.queueErase(index); }
+	void eraseQueued();
+	int size() { return (int)listTypeID.size(); }
+
+
+	SlotMap slots;
+
+
+	std::vector<Uint8> listTypeID;
+	std::vector<Vector2D> listPos;
+	std::vector<Timer> listTimerGrowth;
+	//The animation phase used to make the plants move up and down.
+	std::vector<Timer> listTimerMoveUpAndDown;
+	std::vector<float> listDrawScale, listDrawScalePrevious;
+
+
+	//Every array above, which the bytes stored for each plant are worked out from.  Anything shared
+	//by every plant of a type, such as it's sprites, belongs in the type instead.
+	using Columns = StoreColumns<decltype(listTypeID), decltype(listPos), decltype(listTimerGrowth),
+		decltype(listTimerMoveUpAndDown), decltype(listDrawScale), decltype(listDrawScalePrevious)>;
+	static const size_t bytesPerPlant = Columns::computeBytesPerRow();
+	static_assert(bytesPerPlant <= 40, "A field added to PlantStore made each plant bigger than expected.");
+};
+
+
+
+static_assert(sizeof(PlantStore) == PlantStore::Columns::computeSizeOfStore(sizeof(SlotMap)),
+	"An array in PlantStore is missing from PlantStore::Columns.");
\ No newline at end of file
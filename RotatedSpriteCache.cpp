@@ -0,0 +1,118 @@
+#include "RotatedSpriteCache.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+
+
+void RotatedSpriteCache::setAngleCount(int setAngleCount) {
+	//Atlases built for a different count are left for the TextureLoader to clean up, and new ones
+	//are built as they're needed.
+	if (setAngleCount != angleCount) {
+		angleCount = std::max(setAngleCount, 0);
+		umapAtlases.clear();
+	}
+}
+
+
+
+void RotatedSpriteCache::draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, const Sprite& sprite,
+	SDL_Point posScreenCenter, float zoom, float angleDeg, Uint8 alphaMod) {
+	//Add the sprite to the batch centered on the input position, scaled by the zoom and rotated
+	//clockwise.
+	if (renderer == nullptr || sprite.checkIfLoaded() == false)
+		return;
+
+	Atlas* atlas = (angleCount > 0 ? findOrCreateAtlas(renderer, sprite) : nullptr);
+	if (atlas == nullptr) {
+		//Rotate the quad exactly instead, which the batch does on the CPU.
+		int wZoomed = (int)std::round(sprite.rect.w * zoom), hZoomed = (int)std::round(sprite.rect.h * zoom);
+		SDL_FRect rect = { (float)(posScreenCenter.x - wZoomed / 2), (float)(posScreenCenter.y - hZoomed / 2),
+			(float)wZoomed, (float)hZoomed };
+		spriteBatch.add(sprite.page, sprite.sizePage, sprite.rect, rect, alphaMod, angleDeg);
+		return;
+	}
+
+	//Snap to the nearest cached angle.
+	float angleStep = 360.0f / angleCount;
+	int angleIndex = (int)std::round(angleDeg / angleStep) % angleCount;
+	if (angleIndex < 0)
+		angleIndex += angleCount;
+
+	SDL_Rect rectSource = { (angleIndex % atlas->columnCount) * atlas->cellSize,
+		(angleIndex / atlas->columnCount) * atlas->cellSize, atlas->cellSize, atlas->cellSize };
+	int sizeZoomed = (int)std::round(atlas->cellSize * zoom);
+	SDL_FRect rect = { (float)(posScreenCenter.x - sizeZoomed / 2), (float)(posScreenCenter.y - sizeZoomed / 2),
+		(float)sizeZoomed, (float)sizeZoomed };
+	spriteBatch.add(atlas->texture, atlas->sizeTexture, rectSource, rect, alphaMod);
+}
+
+
+void RotatedSpriteCache::refresh(SDL_Renderer* renderer) {
+	//Draw every atlas again, which is needed if the renderer loses the contents of it's target
+	//textures.
+	for (auto& atlasSelected : umapAtlases)
+		drawAtlas(renderer, atlasSelected.second);
+}
+
+
+
+RotatedSpriteCache::Atlas* RotatedSpriteCache::findOrCreateAtlas(SDL_Renderer* renderer,
+	const Sprite& sprite) {
+	auto found = umapAtlases.find(sprite.id);
+	if (found != umapAtlases.end())
+		return (found->second.texture != nullptr ? &found->second : nullptr);
+
+	Atlas atlas;
+	atlas.spriteSource = sprite;
+	int w = sprite.rect.w, h = sprite.rect.h;
+	atlas.cellSize = (int)std::ceil(std::sqrt((float)(w * w + h * h)));
+	atlas.columnCount = (int)std::ceil(std::sqrt((float)angleCount));
+	int rowCount = (angleCount + atlas.columnCount - 1) / atlas.columnCount;
+
+	//Each source sprite and angle count gets it's own name so the TextureLoader keeps them apart.
+	std::string name = "Rotated " + std::to_string(sprite.id) + " " + std::to_string(angleCount);
+	atlas.sizeTexture = SDL_Point{ atlas.cellSize * atlas.columnCount, atlas.cellSize * rowCount };
+	atlas.texture = TextureLoader::createTargetTexture(renderer, name, atlas.sizeTexture.x,
+		atlas.sizeTexture.y);
+
+	//If the atlas couldn't be created, e.g. it's too big, then remember that so the sprite is
+	//rotated when drawn instead of trying again every frame.
+	Atlas& atlasAdded = umapAtlases[sprite.id];
+	atlasAdded = atlas;
+	if (atlasAdded.texture != nullptr)
+		drawAtlas(renderer, atlasAdded);
+
+	return (atlasAdded.texture != nullptr ? &atlasAdded : nullptr);
+}
+
+
+void RotatedSpriteCache::drawAtlas(SDL_Renderer* renderer, Atlas& atlas) {
+	if (atlas.texture == nullptr)
+		return;
+
+	SDL_Texture* textureTargetPrevious = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, atlas.texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	//Copy the pixels as they are instead of blending them with the cleared atlas, so that the
+	//atlas can be blended later exactly like the source would have been.
+	const Sprite& spriteSource = atlas.spriteSource;
+	SDL_BlendMode blendModePrevious = SDL_BLENDMODE_BLEND;
+	SDL_GetTextureBlendMode(spriteSource.page, &blendModePrevious);
+	SDL_SetTextureBlendMode(spriteSource.page, SDL_BLENDMODE_NONE);
+
+	float angleStep = 360.0f / angleCount;
+	for (int angleIndex = 0; angleIndex < angleCount; angleIndex++) {
+		SDL_Rect rect = {
+			(angleIndex % atlas.columnCount) * atlas.cellSize + (atlas.cellSize - spriteSource.rect.w) / 2,
+			(angleIndex / atlas.columnCount) * atlas.cellSize + (atlas.cellSize - spriteSource.rect.h) / 2,
+			spriteSource.rect.w, spriteSource.rect.h };
+		SDL_RenderCopyEx(renderer, spriteSource.page, &spriteSource.rect, &rect, angleIndex * angleStep,
+			NULL, SDL_FLIP_NONE);
+	}
+
+	SDL_SetTextureBlendMode(spriteSource.page, blendModePrevious);
+	SDL_SetRenderTarget(renderer, textureTargetPrevious);
+}
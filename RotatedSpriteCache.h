@@ -0,0 +1,40 @@
+#pragma once
+#include <unordered_map>
+#include "SDL2/SDL.h"
+#include "TextureLoader.h"
+#include "SpriteBatch.h"
+
+
+
+//Pre-renders sprites at a fixed number of angles into an atlas so that drawing one rotated is an
+//axis aligned copy instead of a rotated quad, which is slow in the software renderer.  Each
+//sprite's atlas is built the first time it's drawn.  With an angle count of zero nothing is
+//cached and the sprites are rotated when they're drawn.
+class RotatedSpriteCache
+{
+public:
+	void setAngleCount(int setAngleCount);
+	void draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, const Sprite& sprite,
+		SDL_Point posScreenCenter, float zoom, float angleDeg, Uint8 alphaMod);
+	void refresh(SDL_Renderer* renderer);
+
+
+private:
+	struct Atlas {
+		SDL_Texture* texture = nullptr;
+		SDL_Point sizeTexture = { 0, 0 };
+		//The sprite that was rendered into the atlas, and the size of each square cell, which fits
+		//it at any angle.
+		Sprite spriteSource;
+		int cellSize = 0, columnCount = 1;
+	};
+
+
+	Atlas* findOrCreateAtlas(SDL_Renderer* renderer, const Sprite& sprite);
+	void drawAtlas(SDL_Renderer* renderer, Atlas& atlas);
+
+
+	int angleCount = 0;
+	//Keyed by the source sprite's id.  The atlases are owned by the TextureLoader.
+	std::unordered_map<int, Atlas> umapAtlases;
+};
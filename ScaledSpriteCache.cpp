@@ -0,0 +1,124 @@
+#include "ScaledSpriteCache.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+
+
+ScaledSpriteCache::ScaledSpriteCache(float setScaleMin, float setScaleMax, int setFrameCount) :
+	scaleMin(setScaleMin), scaleMax(setScaleMax), frameCount(std::max(setFrameCount, 0)) {
+
+}
+
+
+void ScaledSpriteCache::setFrameCount(int setFrameCount) {
+	//Atlases built for a different count are left for the TextureLoader to clean up, and new ones
+	//are built as they're needed.
+	if (setFrameCount != frameCount) {
+		frameCount = std::max(setFrameCount, 0);
+		umapAtlases.clear();
+	}
+}
+
+
+
+void ScaledSpriteCache::draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, const Sprite& sprite,
+	SDL_Point posScreenCenter, float zoom, float scale, Uint8 alphaMod) {
+	//Add the sprite to the batch centered on the input position at the frame nearest the input
+	//scale, and then scaled by the zoom.
+	if (renderer == nullptr || sprite.checkIfLoaded() == false)
+		return;
+
+	Atlas* atlas = (frameCount > 0 ? findOrCreateAtlas(renderer, sprite) : nullptr);
+	if (atlas == nullptr) {
+		int wZoomed = (int)std::round(std::round(sprite.rect.w * scale) * zoom);
+		int hZoomed = (int)std::round(std::round(sprite.rect.h * scale) * zoom);
+		SDL_FRect rect = { (float)(posScreenCenter.x - wZoomed / 2), (float)(posScreenCenter.y - hZoomed / 2),
+			(float)wZoomed, (float)hZoomed };
+		spriteBatch.add(sprite.page, sprite.sizePage, sprite.rect, rect, alphaMod);
+		return;
+	}
+
+	int frameIndex = 0;
+	if (frameCount > 1 && scaleMax > scaleMin)
+		frameIndex = std::min(std::max((int)std::round(
+			(scale - scaleMin) / (scaleMax - scaleMin) * (frameCount - 1)), 0), frameCount - 1);
+
+	const SDL_Rect& rectSource = atlas->listRectFrames[frameIndex];
+	int wZoomed = (int)std::round(rectSource.w * zoom), hZoomed = (int)std::round(rectSource.h * zoom);
+	SDL_FRect rect = { (float)(posScreenCenter.x - wZoomed / 2), (float)(posScreenCenter.y - hZoomed / 2),
+		(float)wZoomed, (float)hZoomed };
+	spriteBatch.add(atlas->texture, atlas->sizeTexture, rectSource, rect, alphaMod);
+}
+
+
+void ScaledSpriteCache::refresh(SDL_Renderer* renderer) {
+	//Draw every atlas again, which is needed if the renderer loses the contents of it's target
+	//textures.
+	for (auto& atlasSelected : umapAtlases)
+		drawAtlas(renderer, atlasSelected.second);
+}
+
+
+
+ScaledSpriteCache::Atlas* ScaledSpriteCache::findOrCreateAtlas(SDL_Renderer* renderer,
+	const Sprite& sprite) {
+	auto found = umapAtlases.find(sprite.id);
+	if (found != umapAtlases.end())
+		return (found->second.texture != nullptr ? &found->second : nullptr);
+
+	Atlas& atlas = umapAtlases[sprite.id];
+	atlas.spriteSource = sprite;
+
+	//Place the frames in a row with a pixel between them so that they don't bleed into each other
+	//when the atlas is drawn scaled.
+	int x = 0;
+	for (int frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+		float scale = computeFrameScale(frameIndex);
+		SDL_Rect rect = { x, 0, (int)std::round(sprite.rect.w * scale), (int)std::round(sprite.rect.h * scale) };
+		atlas.listRectFrames.push_back(rect);
+		x += rect.w + 1;
+	}
+
+	//Each source sprite and frame count gets it's own name so the TextureLoader keeps them apart.
+	//If the atlas couldn't be created then the sprite is scaled when drawn instead.
+	std::string name = "Scaled " + std::to_string(sprite.id) + " " + std::to_string(frameCount);
+	atlas.sizeTexture = SDL_Point{ std::max(x - 1, 1), std::max(sprite.rect.h, 1) };
+	atlas.texture = TextureLoader::createTargetTexture(renderer, name, atlas.sizeTexture.x,
+		atlas.sizeTexture.y);
+	drawAtlas(renderer, atlas);
+
+	return (atlas.texture != nullptr ? &atlas : nullptr);
+}
+
+
+void ScaledSpriteCache::drawAtlas(SDL_Renderer* renderer, Atlas& atlas) {
+	if (atlas.texture == nullptr)
+		return;
+
+	SDL_Texture* textureTargetPrevious = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, atlas.texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	//Copy the pixels as they are instead of blending them with the cleared atlas, so that the
+	//atlas can be blended later exactly like the source would have been.
+	const Sprite& spriteSource = atlas.spriteSource;
+	SDL_BlendMode blendModePrevious = SDL_BLENDMODE_BLEND;
+	SDL_GetTextureBlendMode(spriteSource.page, &blendModePrevious);
+	SDL_SetTextureBlendMode(spriteSource.page, SDL_BLENDMODE_NONE);
+
+	for (const SDL_Rect& rectFrame : atlas.listRectFrames)
+		SDL_RenderCopy(renderer, spriteSource.page, &spriteSource.rect, &rectFrame);
+
+	SDL_SetTextureBlendMode(spriteSource.page, blendModePrevious);
+	SDL_SetRenderTarget(renderer, textureTargetPrevious);
+}
+
+
+float ScaledSpriteCache::computeFrameScale(int frameIndex) {
+	if (frameCount < 2)
+		return scaleMax;
+
+	return scaleMin + (scaleMax - scaleMin) * frameIndex / (frameCount - 1);
+}
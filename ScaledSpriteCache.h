@@ -0,0 +1,43 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "SDL2/SDL.h"
+#include "TextureLoader.h"
+#include "SpriteBatch.h"
+
+
+
+//Pre-renders sprites at a fixed number of scales between scaleMin and scaleMax into an atlas, so
+//that a sprite animated by scaling it is drawn as a copy of the nearest frame instead of being
+//resized every frame.  Each sprite's atlas is built the first time it's drawn.  With a frame
+//count of zero nothing is pre-rendered and the sprites are scaled when they're drawn.
+class ScaledSpriteCache
+{
+public:
+	ScaledSpriteCache(float setScaleMin, float setScaleMax, int setFrameCount);
+	void setFrameCount(int setFrameCount);
+	void draw(SDL_Renderer* renderer, SpriteBatch& spriteBatch, const Sprite& sprite,
+		SDL_Point posScreenCenter, float zoom, float scale, Uint8 alphaMod);
+	void refresh(SDL_Renderer* renderer);
+
+
+private:
+	struct Atlas {
+		SDL_Texture* texture = nullptr;
+		SDL_Point sizeTexture = { 0, 0 };
+		//The sprite that was rendered into the atlas, and where each frame is in the atlas.
+		Sprite spriteSource;
+		std::vector<SDL_Rect> listRectFrames;
+	};
+
+
+	Atlas* findOrCreateAtlas(SDL_Renderer* renderer, const Sprite& sprite);
+	void drawAtlas(SDL_Renderer* renderer, Atlas& atlas);
+	float computeFrameScale(int frameIndex);
+
+
+	const float scaleMin, scaleMax;
+	int frameCount;
+	//Keyed by the source sprite's id.  The atlases are owned by the TextureLoader.
+	std::unordered_map<int, Atlas> umapAtlases;
+};
@@ -0,0 +1,80 @@
+#include "SlotMap.h"
+
+
+
+int SlotMap::add() {
+	//Register an entity added to the back of the store and return it's slot.  Free slots are
+	//reused before the lists grow.
+	int slot;
+	if (listSlotsFree.empty() == false) {
+		slot = listSlotsFree.back();
+		listSlotsFree.pop_back();
+	}
+	else {
+		slot = (int)listIndexForSlot.size();
+		listIndexForSlot.push_back(-1);
+		listGenerationForSlot.push_back(0);
+		listEraseQueuedForSlot.push_back(false);
+	}
+
+	listIndexForSlot[slot] = size();
+	listSlotForIndex.push_back(slot);
+
+	return slot;
+}
+
+
+void SlotMap::eraseSwapWithLast(int index) {
+	//The store moves it's last entity into index, so point that entity's slot at index and free
+	//the slot of the entity that was erased.
+	int slotErased = listSlotForIndex[index];
+	int slotLast = listSlotForIndex.back();
+
+	listSlotForIndex[index] = slotLast;
+	listIndexForSlot[slotLast] = index;
+	listSlotForIndex.pop_back();
+
+	listIndexForSlot[slotErased] = -1;
+	listGenerationForSlot[slotErased]++;
+	listEraseQueuedForSlot[slotErased] = false;
+	listSlotsFree.push_back(slotErased);
+}
+
+
+void SlotMap::queueErase(int index) {
+	int slot = listSlotForIndex[index];
+	if (listEraseQueuedForSlot[slot] == false) {
+		listEraseQueuedForSlot[slot] = true;
+		listSlotsEraseQueued.push_back(slot);
+	}
+}
+
+
+bool SlotMap::checkIfEraseQueued(int index) {
+	return listEraseQueuedForSlot[listSlotForIndex[index]];
+}
+
+
+
+int SlotMap::getIndexForSlot(int slot) {
+	if (slot > -1 && slot < (int)listIndexForSlot.size())
+		return listIndexForSlot[slot];
+
+	return -1;
+}
+
+
+int SlotMap::getIndex(EntityHandle handle) {
+	//Return -1 if the entity that the handle refers to has been erased.
+	if (handle.slot > -1 && handle.slot < (int)listIndexForSlot.size() &&
+		listGenerationForSlot[handle.slot] == handle.generation)
+		return listIndexForSlot[handle.slot];
+
+	return -1;
+}
+
+
+EntityHandle SlotMap::getHandle(int index) {
+	int slot = listSlotForIndex[index];
+	return EntityHandle{ slot, listGenerationForSlot[slot] };
+}
\ No newline at end of file
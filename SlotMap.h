@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include "SDL2/SDL.h"
+
+
+
+//Refers to an entity without depending on where it's stored.  The generation is bumped every time
+//a slot is freed so a handle to an entity that has been erased won't match the slot's new owner.
+struct EntityHandle {
+	int slot = -1;
+	Uint32 generation = 0;
+
+	//False for the handle returned when an entity couldn't be added.
+	bool checkIfValid() const { return (slot > -1); }
+};
+
+
+
+//Maps stable slots to the index of an entity in a densely packed store.  The store erases by
+//swapping the last entity into the hole, and this keeps the slot of the moved entity pointing at
+//it's new index.  Erases can also be queued and then applied in one batch, so that any indices
+//held while the queue is being filled stay valid.
+class SlotMap
+{
+public:
+	int add();
+	void eraseSwapWithLast(int index);
+	void queueErase(int index);
+	bool checkIfEraseQueued(int index);
+	std::vector<int>& getListSlotsEraseQueued() { return listSlotsEraseQueued; }
+
+	int getIndexForSlot(int slot);
+	int getIndex(EntityHandle handle);
+	int getSlot(int index) { return listSlotForIndex[index]; }
+	EntityHandle getHandle(int index);
+	int size() { return (int)listSlotForIndex.size(); }
+
+	//Erase from one of the store's lists in the same way, without shifting the rest of the list.
+	template <typename T>
+	static void swapAndPop(std::vector<T>& list, int index) {
+		list[index] = list.back();
+		list.pop_back();
+	}
+
+
+private:
+	//Indexed by slot.  The index is -1 while the slot is free.
+	std::vector<int> listIndexForSlot;
+	std::vector<Uint32> listGenerationForSlot;
+	std::vector<bool> listEraseQueuedForSlot;
+	std::vector<int> listSlotsFree;
+
+	//Indexed by the entity's index in the store.
+	std::vector<int> listSlotForIndex;
+
+	std::vector<int> listSlotsEraseQueued;
+};
\ No newline at end of file
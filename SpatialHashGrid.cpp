@@ -0,0 +1,101 @@
+#include "SpatialHashGrid.h"
+
+
+
+void SpatialHashGrid::insert(int id, Vector2D pos, float radius) {
+	umapCells[computeKey(computeCell(pos.x), computeCell(pos.y))].push_back(id);
+
+	if (radius > radiusMax)
+		radiusMax = radius;
+}
+
+
+void SpatialHashGrid::remove(int id, Vector2D pos) {
+	auto found = umapCells.find(computeKey(computeCell(pos.x), computeCell(pos.y)));
+	if (found != umapCells.end()) {
+		std::vector<int>& listIDs = found->second;
+		for (size_t count = 0; count < listIDs.size(); count++) {
+			if (listIDs[count] == id) {
+				//Order within a cell doesn't matter so swap it with the last id and remove that.
+				listIDs[count] = listIDs.back();
+				listIDs.pop_back();
+				return;
+			}
+		}
+	}
+}
+
+
+void SpatialHashGrid::move(int id, Vector2D posOld, Vector2D posNew) {
+	//Only update the buckets if the id crossed into a different cell.
+	if (computeCell(posOld.x) != computeCell(posNew.x) ||
+		computeCell(posOld.y) != computeCell(posNew.y)) {
+		remove(id, posOld);
+		umapCells[computeKey(computeCell(posNew.x), computeCell(posNew.y))].push_back(id);
+	}
+}
+
+
+void SpatialHashGrid::clear() {
+	//Keep the cells so their memory can be reused when the grid is filled again.
+	for (auto& cellSelected : umapCells)
+		cellSelected.second.clear();
+}
+
+
+
+const std::vector<int>& SpatialHashGrid::query(Vector2D pos, float radius) {
+	//Return the ids of every entity whose bounding circle could overlap the input circle.  The
+	//caller is responsible for the exact overlap test.
+	listIDsFound.clear();
+
+	float reach = radius + radiusMax;
+	addCellsToFound(computeCell(pos.x - reach), computeCell(pos.y - reach),
+		computeCell(pos.x + reach), computeCell(pos.y + reach));
+
+	return listIDsFound;
+}
+
+
+const std::vector<int>& SpatialHashGrid::queryRect(Vector2D posMin, Vector2D posMax) {
+	//Return the ids of every entity whose bounding circle could overlap the input rectangle.
+	listIDsFound.clear();
+	addCellsToFound(computeCell(posMin.x - radiusMax), computeCell(posMin.y - radiusMax),
+		computeCell(posMax.x + radiusMax), computeCell(posMax.y + radiusMax));
+
+	return listIDsFound;
+}
+
+
+void SpatialHashGrid::addCellsToFound(int cellLeft, int cellTop, int cellRight, int cellBottom) {
+	//When the range covers more cells than the grid has, e.g. a view zoomed far out, it's cheaper
+	//to check each cell in the grid against the range than to look up each cell in the range.
+	if ((int64_t)(cellRight - cellLeft + 1) * (cellBottom - cellTop + 1) > (int64_t)umapCells.size()) {
+		for (auto& cellSelected : umapCells) {
+			int x = (int)(int32_t)(cellSelected.first >> 32);
+			int y = (int)(int32_t)(cellSelected.first & 0xffffffff);
+			if (x >= cellLeft && x <= cellRight && y >= cellTop && y <= cellBottom)
+				listIDsFound.insert(listIDsFound.end(), cellSelected.second.begin(), cellSelected.second.end());
+		}
+		return;
+	}
+
+	for (int y = cellTop; y <= cellBottom; y++) {
+		for (int x = cellLeft; x <= cellRight; x++) {
+			auto found = umapCells.find(computeKey(x, y));
+			if (found != umapCells.end())
+				listIDsFound.insert(listIDsFound.end(), found->second.begin(), found->second.end());
+		}
+	}
+}
+
+
+
+int SpatialHashGrid::computeCell(float value) {
+	return (int)floor(value);
+}
+
+
+uint64_t SpatialHashGrid::computeKey(int cellX, int cellY) {
+	return ((uint64_t)(uint32_t)cellX << 32) | (uint32_t)cellY;
+}
\ No newline at end of file
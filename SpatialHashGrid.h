@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Vector2D.h"
+
+
+
+//Buckets ids into cells that are one tile in size, so that overlap queries only need to look at
+//the entities near the query instead of every entity.  Each id is stored in the cell that contains
+//it's center and queries are expanded by the largest radius that was inserted.
+class SpatialHashGrid
+{
+public:
+	void insert(int id, Vector2D pos, float radius);
+	void remove(int id, Vector2D pos);
+	void move(int id, Vector2D posOld, Vector2D posNew);
+	void clear();
+	const std::vector<int>& query(Vector2D pos, float radius);
+	const std::vector<int>& queryRect(Vector2D posMin, Vector2D posMax);
+
+
+private:
+	static int computeCell(float value);
+	static uint64_t computeKey(int cellX, int cellY);
+	void addCellsToFound(int cellLeft, int cellTop, int cellRight, int cellBottom);
+
+
+	std::unordered_map<uint64_t, std::vector<int>> umapCells;
+	float radiusMax = 0.0f;
+
+	std::vector<int> listIDsFound;
+};
\ No newline at end of file
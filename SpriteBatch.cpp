@@ -0,0 +1,79 @@
+#include "SpriteBatch.h"
+#include <cmath>
+#include "MathAddon.h"
+
+
+
+void SpriteBatch::add(SDL_Texture* texture, SDL_Point sizeTexture, const SDL_Rect& rectSource,
+	const SDL_FRect& rectScreen, Uint8 alphaMod, float angleDeg) {
+	//Add a quad that draws the source rectangle of the texture into the screen rectangle rotated
+	//clockwise around it's center like SDL_RenderCopyEx does.  The caller passes the texture's
+	//size, which it already knows, instead of the batch querying it.
+	if (texture == nullptr || sizeTexture.x <= 0 || sizeTexture.y <= 0)
+		return;
+
+	float uLeft = (float)rectSource.x / sizeTexture.x;
+	float vTop = (float)rectSource.y / sizeTexture.y;
+	float uRight = (float)(rectSource.x + rectSource.w) / sizeTexture.x;
+	float vBottom = (float)(rectSource.y + rectSource.h) / sizeTexture.y;
+
+	//The corners relative to the center, in the order top left, top right, bottom right, bottom
+	//left.
+	float wHalf = rectScreen.w / 2.0f, hHalf = rectScreen.h / 2.0f;
+	SDL_FPoint listCorners[4] = { { -wHalf, -hHalf }, { wHalf, -hHalf }, { wHalf, hHalf }, { -wHalf, hHalf } };
+	SDL_FPoint listTexCoords[4] = { { uLeft, vTop }, { uRight, vTop }, { uRight, vBottom }, { uLeft, vBottom } };
+	float angleRad = MathAddon::angleDegToRad(angleDeg);
+	float fCos = std::cos(angleRad), fSin = std::sin(angleRad);
+
+	Batch& batchSelected = findOrAddBatch(texture);
+	for (int count = 0; count < 4; count++) {
+		SDL_Vertex vertex;
+		vertex.position.x = rectScreen.x + wHalf + listCorners[count].x * fCos - listCorners[count].y * fSin;
+		vertex.position.y = rectScreen.y + hHalf + listCorners[count].x * fSin + listCorners[count].y * fCos;
+		vertex.color = SDL_Color{ 255, 255, 255, alphaMod };
+		vertex.tex_coord = listTexCoords[count];
+		batchSelected.listVertices.push_back(vertex);
+	}
+}
+
+
+void SpriteBatch::draw(SDL_Renderer* renderer) {
+	//Draw every batch with one call each and then empty them.
+	for (int count = 0; count < batchCountUsed; count++) {
+		Batch& batchSelected = listBatches[count];
+		int quadCount = (int)batchSelected.listVertices.size() / 4;
+
+		//Extend the shared indices if this is the largest batch so far.
+		for (int quad = (int)listIndices.size() / 6; quad < quadCount; quad++) {
+			int vertexFirst = quad * 4;
+			for (int offset : { 0, 1, 2, 2, 3, 0 })
+				listIndices.push_back(vertexFirst + offset);
+		}
+
+		if (renderer != nullptr && quadCount > 0)
+			SDL_RenderGeometry(renderer, batchSelected.texture, batchSelected.listVertices.data(),
+				quadCount * 4, listIndices.data(), quadCount * 6);
+
+		batchSelected.texture = nullptr;
+		batchSelected.listVertices.clear();
+	}
+
+	batchCountUsed = 0;
+}
+
+
+
+SpriteBatch::Batch& SpriteBatch::findOrAddBatch(SDL_Texture* texture) {
+	//There are only ever a few textures per layer so a linear search is enough.
+	for (int count = 0; count < batchCountUsed; count++)
+		if (listBatches[count].texture == texture)
+			return listBatches[count];
+
+	if (batchCountUsed == (int)listBatches.size())
+		listBatches.emplace_back();
+
+	Batch& batchAdded = listBatches[batchCountUsed];
+	batchAdded.texture = texture;
+	batchCountUsed++;
+	return batchAdded;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include "SDL2/SDL.h"
+
+
+
+//Collects textured quads and draws all of the ones that use the same texture with a single
+//SDL_RenderGeometry call, so the number of draw calls depends on the number of textures instead of
+//the number of sprites.  Quads are grouped by texture when drawn, so the order between quads with
+//different textures isn't kept.  Draw a batch per layer where the order matters.
+class SpriteBatch
+{
+public:
+	void add(SDL_Texture* texture, SDL_Point sizeTexture, const SDL_Rect& rectSource,
+		const SDL_FRect& rectScreen, Uint8 alphaMod = 255, float angleDeg = 0.0f);
+	void draw(SDL_Renderer* renderer);
+
+
+private:
+	struct Batch {
+		SDL_Texture* texture = nullptr;
+		std::vector<SDL_Vertex> listVertices;
+	};
+
+
+	Batch& findOrAddBatch(SDL_Texture* texture);
+
+
+	//Batches are kept after being drawn so that their memory can be reused.
+	std::vector<Batch> listBatches;
+	int batchCountUsed = 0;
+	//The indices for two triangles per quad, shared by every batch.
+	std::vector<int> listIndices;
+};
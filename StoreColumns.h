@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+
+
+
+//Lists the arrays of a store, which each hold one field for every entity, so that the bytes each
+//entity takes up are worked out from the arrays themselves instead of by hand.
+template <typename... Columns>
+struct StoreColumns
+{
+	static const size_t count = sizeof...(Columns);
+
+	static constexpr size_t computeBytesPerRow() {
+		const size_t listSizes[] = { sizeof(typename Columns::value_type)... };
+		size_t sum = 0;
+		for (size_t sizeSelected : listSizes)
+			sum += sizeSelected;
+
+		return sum;
+	}
+
+	//The size a store with just these arrays and the members it always has would be.  A store
+	//whose size doesn't match has an array that's missing from the list.
+	static constexpr size_t computeSizeOfStore(size_t sizeOtherMembers) {
+		return sizeOtherMembers + count * sizeof(std::vector<char>);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "SurfaceDecodePool.h"
+#include <algorithm>
+
+
+
+SurfaceDecodePool::SurfaceDecodePool(DecodeFunction setDecodeFunction) :
+	decodeFunction(setDecodeFunction) {
+
+}
+
+
+SurfaceDecodePool::~SurfaceDecodePool() {
+	//Let the workers finish the file they're on, then free anything that was never taken.
+	{
+		std::lock_guard<std::mutex> lock(mutexQueue);
+		stopping = true;
+		queueFilenames.clear();
+	}
+	conditionRequested.notify_all();
+
+	for (auto& threadSelected : listThreads)
+		threadSelected.join();
+
+	for (auto& resultSelected : listResults)
+		if (resultSelected.surface != nullptr)
+			SDL_FreeSurface(resultSelected.surface);
+}
+
+
+
+void SurfaceDecodePool::request(const std::string& filename) {
+	//Queue the file to be decoded, unless it already is.
+	{
+		std::lock_guard<std::mutex> lock(mutexQueue);
+		if (stopping || usetFilenamesRequested.insert(filename).second == false)
+			return;
+
+		queueFilenames.push_back(filename);
+	}
+
+	if (listThreads.empty())
+		startWorkers();
+	conditionRequested.notify_one();
+}
+
+
+void SurfaceDecodePool::takeResults(std::vector<Result>& listResultsOut) {
+	//Hand over the files that finished decoding since the last call.  The caller owns the surfaces,
+	//which are nullptr for files that couldn't be decoded.
+	std::lock_guard<std::mutex> lock(mutexQueue);
+	for (auto& resultSelected : listResults) {
+		usetFilenamesRequested.erase(resultSelected.filename);
+		listResultsOut.push_back(resultSelected);
+	}
+	listResults.clear();
+}
+
+
+void SurfaceDecodePool::waitUntilIdle() {
+	std::unique_lock<std::mutex> lock(mutexQueue);
+	conditionIdle.wait(lock, [this]() { return (queueFilenames.empty() && decodingCount == 0); });
+}
+
+
+
+void SurfaceDecodePool::startWorkers() {
+	//Leave a core for the main thread if there's more than one.
+	int threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+	for (int count = 0; count < threadCount; count++)
+		listThreads.push_back(std::thread([this]() { runWorker(); }));
+}
+
+
+void SurfaceDecodePool::runWorker() {
+	std::unique_lock<std::mutex> lock(mutexQueue);
+	while (true) {
+		conditionRequested.wait(lock, [this]() { return (stopping || queueFilenames.empty() == false); });
+		if (stopping)
+			return;
+
+		std::string filename = queueFilenames.front();
+		queueFilenames.pop_front();
+		decodingCount++;
+
+		//Decode without holding the lock so that the other workers can run at the same time.
+		lock.unlock();
+		SDL_Surface* surfaceDecoded = decodeFunction(filename);
+		lock.lock();
+
+		Result resultAdded;
+		resultAdded.filename = filename;
+		resultAdded.surface = surfaceDecoded;
+		listResults.push_back(resultAdded);
+		decodingCount--;
+
+		if (queueFilenames.empty() && decodingCount == 0)
+			conditionIdle.notify_all();
+	}
+}
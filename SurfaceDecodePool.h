@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "SDL2/SDL.h"
+
+
+
+//Decodes images into surfaces on worker threads so that the main thread only has to upload them.
+//The workers are started by the first request and stopped when the pool is destroyed.
+class SurfaceDecodePool
+{
+public:
+	//Called on a worker thread to decode a file into a new surface, or return nullptr.
+	using DecodeFunction = SDL_Surface* (*)(std::string filename);
+
+	struct Result {
+		std::string filename;
+		SDL_Surface* surface = nullptr;
+	};
+
+
+	SurfaceDecodePool(DecodeFunction setDecodeFunction);
+	~SurfaceDecodePool();
+	SurfaceDecodePool(const SurfaceDecodePool&) = delete;
+	SurfaceDecodePool& operator=(const SurfaceDecodePool&) = delete;
+
+	void request(const std::string& filename);
+	void takeResults(std::vector<Result>& listResultsOut);
+	void waitUntilIdle();
+
+
+private:
+	void startWorkers();
+	void runWorker();
+
+
+	const DecodeFunction decodeFunction;
+
+	std::vector<std::thread> listThreads;
+	bool stopping = false;
+
+	//Everything below is shared with the workers and guarded by mutexQueue.
+	std::mutex mutexQueue;
+	std::condition_variable conditionRequested, conditionIdle;
+	std::deque<std::string> queueFilenames;
+	//Requested and not taken yet, so that each file is only decoded once at a time.
+	std::unordered_set<std::string> usetFilenamesRequested;
+	std::vector<Result> listResults;
+	int decodingCount = 0;
+};
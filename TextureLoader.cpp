@@ -1,11 +1,315 @@
 #include "TextureLoader.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iterator>
 
 
+AssetPack TextureLoader::assetPack;
 std::unordered_map<std::string, SDL_Texture*> TextureLoader::umapTexturesLoaded;
+std::unordered_map<std::string, Sprite> TextureLoader::umapSpritesLoaded;
+std::unordered_map<std::string, int> TextureLoader::umapAssetIDs;
+std::vector<std::string> TextureLoader::listAssetFilenames;
+std::vector<Sprite> TextureLoader::listSpritesByAssetID;
+//Defined after the asset pack so that the workers are stopped before the pack is closed.
+SurfaceDecodePool TextureLoader::decodePool(TextureLoader::loadSurface);
+std::vector<SurfaceDecodePool::Result> TextureLoader::listDecodeResults;
+std::unordered_set<std::string> TextureLoader::usetFilenamesFailed;
+Sprite TextureLoader::spritePlaceholder;
 
 
 
 
+bool TextureLoader::openAssetPack(std::string filepathPack) {
+    //Read the images from the pack from now on.  If it can't be opened then the loose files in
+    //Data/Images are used instead, e.g. during development.
+    return assetPack.open(filepathPack);
+}
+
+
+bool TextureLoader::buildAssetPack(std::string filepathPack, std::string filenameManifest) {
+    //Write the manifest and every image listed in it from Data/Images into a pack.
+    std::vector<std::string> listFilenames;
+    readManifest(filenameManifest, listFilenames);
+    listFilenames.insert(listFilenames.begin(), filenameManifest);
+    return AssetPack::build(filepathPack, "Data/Images/", listFilenames);
+}
+
+
+
+void TextureLoader::loadAtlas(SDL_Renderer* renderer, std::string filenameManifest) {
+    //Pack every image listed in the manifest into as few atlas pages as possible.  Images that
+    //aren't listed are still loaded into their own textures as needed.  The images are decoded
+    //in parallel, and only uploaded on this thread.
+    std::vector<std::string> listFilenamesManifest, listFilenames;
+    std::vector<SDL_Surface*> listSurfaces;
+    readManifest(filenameManifest, listFilenamesManifest);
+
+    for (const auto& filenameSelected : listFilenamesManifest)
+        if (umapSpritesLoaded.find(filenameSelected) == umapSpritesLoaded.end())
+            decodePool.request(filenameSelected);
+
+    decodePool.waitUntilIdle();
+    listDecodeResults.clear();
+    decodePool.takeResults(listDecodeResults);
+
+    std::unordered_map<std::string, SDL_Surface*> umapSurfacesDecoded;
+    for (auto& resultSelected : listDecodeResults)
+        umapSurfacesDecoded[resultSelected.filename] = resultSelected.surface;
+
+    //Keep the manifest's order so that the pages are laid out the same way every time.
+    for (const auto& filenameSelected : listFilenamesManifest) {
+        auto found = umapSurfacesDecoded.find(filenameSelected);
+        if (found != umapSurfacesDecoded.end()) {
+            if (found->second != nullptr) {
+                listFilenames.push_back(filenameSelected);
+                listSurfaces.push_back(found->second);
+            }
+            else
+                markFailed(filenameSelected);
+
+            umapSurfacesDecoded.erase(found);
+        }
+    }
+
+    //Anything else that finished was requested before this and isn't in the manifest.
+    for (auto& surfaceSelected : umapSurfacesDecoded) {
+        if (surfaceSelected.second == nullptr ||
+            addSurfaceAsSprite(renderer, surfaceSelected.first, surfaceSelected.second).checkIfLoaded() == false)
+            markFailed(surfaceSelected.first);
+        if (surfaceSelected.second != nullptr)
+            SDL_FreeSurface(surfaceSelected.second);
+    }
+
+    packAtlasPages(renderer, listFilenames, listSurfaces);
+
+    for (auto& surfaceSelected : listSurfaces)
+        SDL_FreeSurface(surfaceSelected);
+}
+
+
+void TextureLoader::packAtlasPages(SDL_Renderer* renderer, std::vector<std::string>& listFilenames,
+    std::vector<SDL_Surface*>& listSurfaces) {
+    //Place the images in rows from tallest to shortest, starting a new row when one is full and a
+    //new page when a page is full.  A pixel is left around each image so that they don't bleed into
+    //each other when drawn scaled.
+    int pageSize = atlasPageSizeMax;
+    SDL_RendererInfo rendererInfo;
+    if (SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && rendererInfo.max_texture_width > 0)
+        pageSize = std::min({ pageSize, rendererInfo.max_texture_width, rendererInfo.max_texture_height });
+
+    std::vector<int> listOrder(listSurfaces.size());
+    for (int count = 0; count < (int)listOrder.size(); count++)
+        listOrder[count] = count;
+    std::sort(listOrder.begin(), listOrder.end(), [&listSurfaces](int a, int b) {
+        return listSurfaces[a]->h > listSurfaces[b]->h; });
+
+    const int padding = 1;
+    size_t orderIndex = 0;
+    while (orderIndex < listOrder.size()) {
+        SDL_Surface* surfacePage = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32,
+            SDL_PIXELFORMAT_ABGR8888);
+        if (surfacePage == nullptr)
+            return;
+        SDL_FillRect(surfacePage, NULL, 0);
+
+        //The images placed on this page and where.
+        std::vector<std::pair<int, SDL_Rect>> listPlaced;
+        int x = padding, y = padding, heightRow = 0;
+        for (; orderIndex < listOrder.size(); orderIndex++) {
+            SDL_Surface* surfaceSelected = listSurfaces[listOrder[orderIndex]];
+            if (x + surfaceSelected->w + padding > pageSize) {
+                x = padding;
+                y += heightRow + padding;
+                heightRow = 0;
+            }
+            if (y + surfaceSelected->h + padding > pageSize ||
+                surfaceSelected->w + padding * 2 > pageSize)
+                break;
+
+            //Copy the pixels as they are, including their transparency.
+            SDL_Rect rect = { x, y, surfaceSelected->w, surfaceSelected->h };
+            SDL_SetSurfaceBlendMode(surfaceSelected, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaceSelected, NULL, surfacePage, &rect);
+            listPlaced.push_back(std::make_pair(listOrder[orderIndex], rect));
+
+            x += surfaceSelected->w + padding;
+            heightRow = std::max(heightRow, surfaceSelected->h);
+        }
+
+        //An image too big to fit on an empty page is loaded into it's own texture when needed.
+        if (listPlaced.empty()) {
+            orderIndex++;
+            SDL_FreeSurface(surfacePage);
+            continue;
+        }
+
+        SDL_Texture* texturePage = SDL_CreateTextureFromSurface(renderer, surfacePage);
+        SDL_FreeSurface(surfacePage);
+        if (texturePage == nullptr)
+            return;
+
+        SDL_SetTextureBlendMode(texturePage, SDL_BLENDMODE_BLEND);
+        umapTexturesLoaded["Atlas Page " + std::to_string(umapTexturesLoaded.size())] = texturePage;
+        for (auto& placedSelected : listPlaced)
+            addSprite(listFilenames[placedSelected.first], texturePage, SDL_Point{ pageSize, pageSize },
+                placedSelected.second);
+    }
+}
+
+
+
+Sprite TextureLoader::loadSprite(SDL_Renderer* renderer, std::string filename) {
+    //Return the image from the atlas if it was packed, or otherwise load it into it's own texture.
+    auto found = umapSpritesLoaded.find(filename);
+    if (found != umapSpritesLoaded.end())
+        return found->second;
+
+    SDL_Texture* textureLoaded = loadTexture(renderer, filename);
+    if (textureLoaded != nullptr) {
+        SDL_Rect rect = { 0, 0, 0, 0 };
+        SDL_QueryTexture(textureLoaded, NULL, NULL, &rect.w, &rect.h);
+        return addSprite(filename, textureLoaded, SDL_Point{ rect.w, rect.h }, rect);
+    }
+
+    return Sprite();
+}
+
+
+int TextureLoader::registerAsset(std::string filename) {
+    //Return the image's asset id, giving it the next one if it doesn't have one yet.  The sprite
+    //is filled in whenever the image is loaded.
+    auto found = umapAssetIDs.find(filename);
+    if (found != umapAssetIDs.end())
+        return found->second;
+
+    int assetID = (int)listAssetFilenames.size();
+    umapAssetIDs[filename] = assetID;
+    listAssetFilenames.push_back(filename);
+
+    auto foundSprite = umapSpritesLoaded.find(filename);
+    listSpritesByAssetID.push_back(foundSprite != umapSpritesLoaded.end() ? foundSprite->second : Sprite());
+
+    return assetID;
+}
+
+
+Sprite TextureLoader::requestSprite(SDL_Renderer* renderer, int assetID) {
+    //Only the first request for an asset goes through it's filename.  After that the asset's
+    //sprite says whether it's loaded, still decoding or failed.
+    if (assetID < 0 || assetID >= (int)listSpritesByAssetID.size())
+        return Sprite();
+
+    Sprite& spriteSelected = listSpritesByAssetID[assetID];
+    if (spriteSelected.checkIfLoaded() || spriteSelected.isPlaceholder || spriteSelected.failed)
+        return spriteSelected;
+
+    spriteSelected = requestSprite(renderer, listAssetFilenames[assetID]);
+    if (spriteSelected.checkIfLoaded() == false && spriteSelected.isPlaceholder == false)
+        spriteSelected.failed = true;
+
+    return spriteSelected;
+}
+
+
+Sprite TextureLoader::requestSprite(SDL_Renderer* renderer, const std::string& filename) {
+    //Like loadSprite, but if the image isn't loaded yet then it's decoded in the background and
+    //the placeholder is returned until update uploads it.  The caller asks again to get it.
+    auto found = umapSpritesLoaded.find(filename);
+    if (found != umapSpritesLoaded.end())
+        return found->second;
+
+    if (usetFilenamesFailed.find(filename) != usetFilenamesFailed.end())
+        return Sprite();
+
+    decodePool.request(filename);
+    return getSpritePlaceholder(renderer);
+}
+
+
+void TextureLoader::update(SDL_Renderer* renderer) {
+    //Upload the images that finished decoding since the last frame.
+    listDecodeResults.clear();
+    decodePool.takeResults(listDecodeResults);
+
+    for (auto& resultSelected : listDecodeResults) {
+        if (resultSelected.surface != nullptr) {
+            if (addSurfaceAsSprite(renderer, resultSelected.filename, resultSelected.surface).checkIfLoaded() == false)
+                markFailed(resultSelected.filename);
+            SDL_FreeSurface(resultSelected.surface);
+        }
+        else
+            markFailed(resultSelected.filename);
+    }
+}
+
+
+Sprite TextureLoader::addSprite(std::string filename, SDL_Texture* page, SDL_Point sizePage, SDL_Rect rect) {
+    Sprite spriteAdded;
+    spriteAdded.page = page;
+    spriteAdded.rect = rect;
+    spriteAdded.sizePage = sizePage;
+    spriteAdded.id = (int)umapSpritesLoaded.size();
+    umapSpritesLoaded[filename] = spriteAdded;
+
+    auto found = umapAssetIDs.find(filename);
+    if (found != umapAssetIDs.end())
+        listSpritesByAssetID[found->second] = spriteAdded;
+
+    return spriteAdded;
+}
+
+
+Sprite TextureLoader::addSurfaceAsSprite(SDL_Renderer* renderer, std::string filename, SDL_Surface* surface) {
+    //Upload the surface into it's own texture, unless the image was loaded another way meanwhile.
+    //The caller still owns the surface.
+    auto found = umapSpritesLoaded.find(filename);
+    if (found != umapSpritesLoaded.end())
+        return found->second;
+
+    SDL_Texture* textureOutput = SDL_CreateTextureFromSurface(renderer, surface);
+    if (textureOutput == nullptr)
+        return Sprite();
+
+    SDL_SetTextureBlendMode(textureOutput, SDL_BLENDMODE_BLEND);
+    umapTexturesLoaded[filename] = textureOutput;
+
+    return addSprite(filename, textureOutput, SDL_Point{ surface->w, surface->h },
+        SDL_Rect{ 0, 0, surface->w, surface->h });
+}
+
+
+Sprite TextureLoader::getSpritePlaceholder(SDL_Renderer* renderer) {
+    //A translucent grey square, created the first time it's needed.  It's still marked as a
+    //placeholder if it couldn't be created, so that callers know the image is on it's way.
+    if (spritePlaceholder.checkIfLoaded() == false) {
+        const int size = 16;
+        SDL_Surface* surfacePlaceholder = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32,
+            SDL_PIXELFORMAT_ABGR8888);
+        if (surfacePlaceholder != nullptr) {
+            SDL_FillRect(surfacePlaceholder, NULL, SDL_MapRGBA(surfacePlaceholder->format, 128, 128, 128, 160));
+            spritePlaceholder = addSurfaceAsSprite(renderer, "Placeholder", surfacePlaceholder);
+            SDL_FreeSurface(surfacePlaceholder);
+        }
+        spritePlaceholder.isPlaceholder = true;
+    }
+
+    return spritePlaceholder;
+}
+
+
+void TextureLoader::markFailed(const std::string& filename) {
+    usetFilenamesFailed.insert(filename);
+
+    auto found = umapAssetIDs.find(filename);
+    if (found != umapAssetIDs.end()) {
+        listSpritesByAssetID[found->second] = Sprite();
+        listSpritesByAssetID[found->second].failed = true;
+    }
+}
+
+
+
 SDL_Texture* TextureLoader::loadTexture(SDL_Renderer* renderer, std::string filename) {
     if (filename != "") {
         auto found = umapTexturesLoaded.find(filename);
@@ -15,11 +319,8 @@ SDL_Texture* TextureLoader::loadTexture(SDL_Renderer* renderer, std::string file
             return found->second;
         }
         else {
-            //Setup the relative filepath to the images folder using the input filename.
-            std::string filepath = "Data/Images/" + filename;
-
-            //Try to create a surface using the filepath.
-            SDL_Surface* surfaceTemp = SDL_LoadBMP(filepath.c_str());
+            //Try to create a surface using the filename.
+            SDL_Surface* surfaceTemp = loadSurface(filename);
             if (surfaceTemp != nullptr) {
 
                 //The surface was created successfully so attempt to create a texture with it.
@@ -45,6 +346,78 @@ SDL_Texture* TextureLoader::loadTexture(SDL_Renderer* renderer, std::string file
 }
 
 
+void TextureLoader::readManifest(std::string filenameManifest, std::vector<std::string>& listFilenamesOut) {
+    //The manifest lists one image filename per line.
+    std::string text;
+    SDL_RWops* rwEntry = assetPack.openEntry(filenameManifest);
+    if (rwEntry != nullptr) {
+        Sint64 size = SDL_RWsize(rwEntry);
+        if (size > 0) {
+            text.resize((size_t)size);
+            SDL_RWread(rwEntry, &text[0], 1, (size_t)size);
+        }
+        SDL_RWclose(rwEntry);
+    }
+    else {
+        std::ifstream fileManifest("Data/Images/" + filenameManifest);
+        text.assign(std::istreambuf_iterator<char>(fileManifest), std::istreambuf_iterator<char>());
+    }
+
+    std::istringstream streamText(text);
+    std::string line;
+    while (std::getline(streamText, line)) {
+        //Allow files saved with Windows line endings.
+        if (line.empty() == false && line.back() == '\r')
+            line.pop_back();
+
+        if (line != "")
+            listFilenamesOut.push_back(line);
+    }
+}
+
+
+SDL_Surface* TextureLoader::loadSurface(std::string filename) {
+    //Decode the image straight from the pack's memory if it has it.
+    SDL_RWops* rwEntry = assetPack.openEntry(filename);
+    if (rwEntry != nullptr)
+        return SDL_LoadBMP_RW(rwEntry, 1);
+
+    //Setup the relative filepath to the images folder using the input filename.
+    std::string filepath = "Data/Images/" + filename;
+    return SDL_LoadBMP(filepath.c_str());
+}
+
+
+
+SDL_Texture* TextureLoader::createTargetTexture(SDL_Renderer* renderer, std::string name, int w, int h) {
+    //Create a texture that can be drawn to, and keep track of it under the input name so that it's
+    //cleaned up along with the loaded textures.
+    if (name != "") {
+        auto found = umapTexturesLoaded.find(name);
+
+        if (found != umapTexturesLoaded.end()) {
+            //The texture was already created so return it.
+            return found->second;
+        }
+        else {
+            SDL_Texture* textureOutput = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888,
+                SDL_TEXTUREACCESS_TARGET, w, h);
+
+            if (textureOutput != nullptr) {
+                //Enable transparency for the texture.
+                SDL_SetTextureBlendMode(textureOutput, SDL_BLENDMODE_BLEND);
+
+                umapTexturesLoaded[name] = textureOutput;
+
+                return textureOutput;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+
 
 void TextureLoader::deallocateTextures() {
     //Destroy all the textures
@@ -55,4 +428,10 @@ void TextureLoader::deallocateTextures() {
 
         umapTexturesLoaded.erase(it);
     }
+
+    umapSpritesLoaded.clear();
+    //The asset ids stay registered, but their images will need loading again.
+    std::fill(listSpritesByAssetID.begin(), listSpritesByAssetID.end(), Sprite());
+    usetFilenamesFailed.clear();
+    spritePlaceholder = Sprite();
 }
\ No newline at end of file
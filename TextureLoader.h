@@ -1,17 +1,76 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include "SDL2/SDL.h"
+#include "AssetPack.h"
+#include "SurfaceDecodePool.h"
+
+
+
+//An image inside a texture, which is usually an atlas page shared with other images so that
+//sprites from the same page can be drawn together.  The id is unique for each image loaded.
+struct Sprite {
+	SDL_Texture* page = nullptr;
+	SDL_Rect rect = { 0, 0, 0, 0 };
+	int id = -1;
+	//The size of the whole page, for working out where the rect is on it.
+	SDL_Point sizePage = { 0, 0 };
+	//Drawn in place of an image that's still being decoded.
+	bool isPlaceholder = false;
+	//The image couldn't be loaded, so there's no point asking for it again.
+	bool failed = false;
+
+	bool checkIfLoaded() const { return (page != nullptr); }
+	//Whether asking for the image again could give anything different.
+	bool checkIfResolved() const { return ((page != nullptr && isPlaceholder == false) || failed); }
+};
 
 
 
 class TextureLoader
 {
 public:
+	static bool openAssetPack(std::string filepathPack);
+	static bool buildAssetPack(std::string filepathPack, std::string filenameManifest);
+	static void loadAtlas(SDL_Renderer* renderer, std::string filenameManifest);
+	static Sprite loadSprite(SDL_Renderer* renderer, std::string filename);
+	static int registerAsset(std::string filename);
+	static Sprite requestSprite(SDL_Renderer* renderer, const std::string& filename);
+	static Sprite requestSprite(SDL_Renderer* renderer, int assetID);
+	static void update(SDL_Renderer* renderer);
 	static SDL_Texture* loadTexture(SDL_Renderer* renderer, std::string filename);
+	static SDL_Texture* createTargetTexture(SDL_Renderer* renderer, std::string name, int w, int h);
 	static void deallocateTextures();
 
 
 private:
+	static void readManifest(std::string filenameManifest, std::vector<std::string>& listFilenamesOut);
+	static SDL_Surface* loadSurface(std::string filename);
+	static void packAtlasPages(SDL_Renderer* renderer, std::vector<std::string>& listFilenames,
+		std::vector<SDL_Surface*>& listSurfaces);
+	static Sprite addSprite(std::string filename, SDL_Texture* page, SDL_Point sizePage, SDL_Rect rect);
+	static Sprite addSurfaceAsSprite(SDL_Renderer* renderer, std::string filename, SDL_Surface* surface);
+	static Sprite getSpritePlaceholder(SDL_Renderer* renderer);
+	static void markFailed(const std::string& filename);
+
+
+	//The images are read from here if it's open and has them, or else from the loose files.
+	static AssetPack assetPack;
 	static std::unordered_map<std::string, SDL_Texture*> umapTexturesLoaded;
-};
\ No newline at end of file
+	static std::unordered_map<std::string, Sprite> umapSpritesLoaded;
+	//Images registered up front get a dense asset id, so that their sprites can be found by index
+	//instead of by building and hashing their filenames.  Each asset's sprite is empty until it's
+	//requested, then the placeholder while it decodes, and then either loaded or failed.
+	static std::unordered_map<std::string, int> umapAssetIDs;
+	static std::vector<std::string> listAssetFilenames;
+	static std::vector<Sprite> listSpritesByAssetID;
+	//Images are decoded here off the main thread, which only uploads them to textures.
+	static SurfaceDecodePool decodePool;
+	static std::vector<SurfaceDecodePool::Result> listDecodeResults;
+	static std::unordered_set<std::string> usetFilenamesFailed;
+	static Sprite spritePlaceholder;
+	//The largest size of an atlas page, if the renderer supports it.
+	static const int atlasPageSizeMax = 1024;
+};
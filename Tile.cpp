@@ -1,176 +1,152 @@
 #include "Tile.h"
 
 
-const std::vector<Tile::Type> Tile::listTileTypes = {
-	{ "water", 0, SDL_Color{ 0, 67, 190 }, SDL_Color{ 0, 67, 190 } },
-	{ "dirt", 1, SDL_Color{ 138, 47, 50 }, SDL_Color{ 158, 56, 62 } },
-	{ "grassPurple", 2, SDL_Color{ 184, 33, 117 }, SDL_Color{ 218, 50, 143 } },
-	{ "grassGreen", 2, SDL_Color{ 11, 100, 100 }, SDL_Color{ 14, 131, 131 } },
-	{ "grassYellow", 2, SDL_Color{ 184, 176, 33 }, SDL_Color{ 218, 209, 50 } },
-	{ "grassBlue", 2, SDL_Color{ 33, 41, 184 }, SDL_Color{ 50, 59, 218 } },
-	{ "grassWhite", 2, SDL_Color{ 167, 167, 167 }, SDL_Color{ 199, 199, 199 } }
-};
+constexpr std::array<Tile::Type, Tile::typeCount> Tile::listTileTypes;
 
-std::vector<SDL_Texture*> Tile::listTextureTileShadows;
+std::vector<Sprite> Tile::listSpriteTileShadows;
+SDL_Texture* Tile::textureShadowAtlas = nullptr;
+int Tile::shadowAtlasCellSize = 0;
 
 
 
 
-Tile::Tile(SDL_Renderer* renderer) :
-	typeID(2) {
+Tile::Tile() :
+	typeID(TypeID::grassPurple) {
+	//A type missing from listTileTypes is zero filled, which fails this check.
+	static_assert(checkTypesValid(), "listTileTypes has a type with invalid flags.");
+}
+
 
+void Tile::loadShadowTextures(SDL_Renderer* renderer) {
 	//Load the shadow textures once only.
-	if (listTextureTileShadows.empty()) {
+	if (listSpriteTileShadows.empty()) {
 		std::vector<std::string> listTileShadowNames{ "Top Left", "Top", "Top Right", "Left",
 				"Right", "Bottom Left", "Bottom", "Bottom Right" };
 
 		for (const auto& nameSelected : listTileShadowNames)
-			listTextureTileShadows.push_back(TextureLoader::loadTexture(renderer,
+			listSpriteTileShadows.push_back(TextureLoader::loadSprite(renderer,
 				"Tile Shadow " + nameSelected + ".bmp"));
 	}
-}
-
 
+	//Composite every combination of the shadow images into one atlas so that each tile only
+	//needs one copy to draw all of it's shadows.
+	if (textureShadowAtlas == nullptr && listSpriteTileShadows.front().checkIfLoaded()) {
+		shadowAtlasCellSize = listSpriteTileShadows.front().rect.w;
+		int atlasSize = shadowAtlasCellSize * shadowAtlasColumns;
+		textureShadowAtlas = TextureLoader::createTargetTexture(renderer, "Tile Shadow Atlas",
+			atlasSize, atlasSize);
+		refreshShadowAtlas(renderer);
+	}
+}
 
-void Tile::draw(SDL_Renderer* renderer, int x, int y, int tileSize) {
-	if (typeID > -1 && typeID < listTileTypes.size()) {
-		const Type& typeSelected = listTileTypes[typeID];
-		bool dark = ((x + y) % 2 == 0);
 
-		//Set the correct color.
-		SDL_Color colorTile = (dark ? typeSelected.colorDark : typeSelected.colorLight);
-		//If it's wet dirt then make it darker.
-		if (typeSelected.name == "dirt" && isWet) {
-			const float fWet = 0.65f;
-			colorTile.r = (Uint8)(colorTile.r * fWet);
-			colorTile.g = (Uint8)(colorTile.g * fWet);
-			colorTile.b = (Uint8)(colorTile.b * fWet);
+void Tile::refreshShadowAtlas(SDL_Renderer* renderer) {
+	//Draw the shadow images for every possible mask into it's own cell of the atlas.  This is
+	//also needed if the renderer loses the contents of it's target textures.
+	if (textureShadowAtlas != nullptr) {
+		SDL_Texture* textureTargetPrevious = SDL_GetRenderTarget(renderer);
+		SDL_SetRenderTarget(renderer, textureShadowAtlas);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+
+		for (int mask = 1; mask < 256; mask++) {
+			SDL_Rect rect = computeShadowAtlasRect(mask);
+			for (int count = 0; count < listSpriteTileShadows.size(); count++) {
+				const Sprite& spriteSelected = listSpriteTileShadows[count];
+				if ((mask & (1 << count)) && spriteSelected.checkIfLoaded())
+					SDL_RenderCopy(renderer, spriteSelected.page, &spriteSelected.rect, &rect);
+			}
 		}
-		SDL_SetRenderDrawColor(renderer, colorTile.r, colorTile.g, colorTile.b, 255);
 
-		//Draw the tile.
-		SDL_Rect rect = { x * tileSize, y * tileSize, tileSize, tileSize };
-		SDL_RenderFillRect(renderer, &rect);
+		SDL_SetRenderTarget(renderer, textureTargetPrevious);
 	}
 }
 
 
-void Tile::drawShadows(SDL_Renderer* renderer, int x, int y, int tileSize,
-	std::vector<Tile>& listTiles, int tileCountX, int tileCountY) {
-	//Setup a rectangle for drawing purposes.
-	SDL_Rect rect = { x * tileSize, y * tileSize, tileSize, tileSize };
-
-	//Loop through the list and draw each shadow image as required.
-	for (int count = 0; count < listTextureTileShadows.size(); count++) {
-		SDL_Texture* textureSelected = listTextureTileShadows[count];
-		if (textureSelected != nullptr) {
-			//Map count to an index on a 3x3 grid.  If count is the center tile or greater then skip it.
-			int index = count;
-			if (count >= 4)
-				index++;
-
-			//Convert index to an x and y offset ranging from -1 to 1 for a 3x3 grid.
-			int xOff = index % 3 - 1;
-			int yOff = index / 3 - 1;
-
-			//Check if offset tile is a corner, then draw the shadow image if required.
-			bool isCorner = (abs(xOff) == 1 && abs(yOff) == 1);
-			if (isCorner) {
-				if (isTileHigher(x + xOff, y + yOff, listTiles, tileCountX, tileCountY) &&
-					isTileHigher(x + xOff, y, listTiles, tileCountX, tileCountY) == false &&
-					isTileHigher(x, y + yOff, listTiles, tileCountX, tileCountY) == false)
-					SDL_RenderCopy(renderer, textureSelected, NULL, &rect);
-			}
-			else {
-				if (isTileHigher(x + xOff, y + yOff, listTiles, tileCountX, tileCountY))
-					SDL_RenderCopy(renderer, textureSelected, NULL, &rect);
-			}
-		}
-	}
+SDL_Rect Tile::computeShadowAtlasRect(int mask) {
+	return SDL_Rect{ (mask % shadowAtlasColumns) * shadowAtlasCellSize,
+		(mask / shadowAtlasColumns) * shadowAtlasCellSize, shadowAtlasCellSize, shadowAtlasCellSize };
 }
 
 
 
-void Tile::setTypeID(int setTypeID) {
-	if (setTypeID > -1 && setTypeID < listTileTypes.size())
-		typeID = setTypeID;
+void Tile::draw(SDL_Renderer* renderer, int x, int y, const SDL_Rect& rectScreen) const {
+	//Set the correct color.
+	SDL_Color colorTile = computeColor(x, y);
+	SDL_SetRenderDrawColor(renderer, colorTile.r, colorTile.g, colorTile.b, 255);
+
+	//Draw the tile.
+	SDL_RenderFillRect(renderer, &rectScreen);
 }
 
 
+SDL_Color Tile::computeColor(int x, int y) const {
+	const Type& typeSelected = listTileTypes[(size_t)typeID];
+	bool dark = ((x + y) % 2 == 0);
 
-void Tile::refreshSurroundingIsWet(int x, int y,
-	std::vector<Tile>& listTiles, int tileCountX, int tileCountY) {
-	//Refresh isWet for all the tiles within the specified distance of the input x, y position.
-    
-    //How far the water spreads.
-	const int distance = 2;
-
-	//Loop through any tiles surrounding the input x, y position.
-	for (int x2 = x - distance; x2 <= x + distance; x2++) {
-		for (int y2 = y - distance; y2 <= y + distance; y2++) {
-			//Ensure that the tile exists.
-			int index2 = x2 + y2 * tileCountX;
-			if (index2 > -1 && index2 < listTiles.size() &&
-				x2 > -1 && x2 < tileCountX &&
-				y2 > -1 && y2 < tileCountY) {
-
-				//Check to see if at least one tile surrounding the x2, y2 position is water.
-				bool foundWater = false;
-				for (int x3 = x2 - distance; x3 <= x2 + distance && foundWater == false; x3++) {
-					for (int y3 = y2 - distance; y3 <= y2 + distance && foundWater == false; y3++) {
-						//Ensure that the tile exists.
-						int index3 = x3 + y3 * tileCountX;
-						if (index3 > -1 && index3 < listTiles.size() &&
-							x3 > -1 && x3 < tileCountX &&
-							y3 > -1 && y3 < tileCountY) {
-
-							//Ensure that the typeID exists, then check if it's water.
-							int typeIDSelected = listTiles[index3].typeID;
-							if (typeIDSelected > -1 && typeIDSelected < listTileTypes.size() &&
-								listTileTypes[typeIDSelected].name == "water") {
-								foundWater = true;
-							}
-						}
-					}
-				}
-
-				//Set isWet for the selected tile.
-				listTiles[index2].isWet = foundWater;
-			}
-		}
+	SDL_Color colorTile = (dark ? typeSelected.colorDark : typeSelected.colorLight);
+	//If it's wet dirt then make it darker.
+	if ((typeSelected.flags & isDirt) && checkIfWet()) {
+		const float fWet = 0.65f;
+		colorTile.r = (Uint8)(colorTile.r * fWet);
+		colorTile.g = (Uint8)(colorTile.g * fWet);
+		colorTile.b = (Uint8)(colorTile.b * fWet);
 	}
+
+	return colorTile;
 }
 
 
+void Tile::drawShadows(SDL_Renderer* renderer, const SDL_Rect& rectScreen) const {
+	if (shadowMask != 0 && textureShadowAtlas != nullptr) {
+		//Copy the atlas cell that already contains every shadow image in the mask.
+		SDL_Rect rectSource = computeShadowAtlasRect(shadowMask);
+		SDL_RenderCopy(renderer, textureShadowAtlas, &rectSource, &rectScreen);
+	}
+}
 
-bool Tile::isTileHigher(int x, int y,
-	std::vector<Tile>& listTiles, int tileCountX, int tileCountY) {
-	if (typeID > -1 && typeID < listTileTypes.size()) {
-		int indexOther = x + y * tileCountX;
-		if (indexOther > -1 && indexOther < listTiles.size() &&
-			x > -1 && x < tileCountX &&
-			y > -1 && y < tileCountY) {
-			int typeIDOther = listTiles[indexOther].typeID;
 
-			//Compare the heights.
-			if (typeIDOther > -1 && typeIDOther < listTileTypes.size())
-				return listTileTypes[typeIDOther].height > listTileTypes[typeID].height;
-		}
+Uint8 Tile::computeShadowMask(const TypeID (&listTypeIDsAround)[9]) {
+	//Determine which of the shadow images need to be drawn based on the heights of the
+	//surrounding tiles, which are passed in as a 3x3 grid with this tile in the center.  Tiles
+	//outside of the level should be passed in as the same type as the center.
+	TypeID typeIDCenter = listTypeIDsAround[4];
+	Uint8 shadowMaskNew = 0;
+
+	for (int count = 0; count < 8; count++) {
+		//Map count to an index on a 3x3 grid.  If count is the center tile or greater then skip it.
+		int index = count;
+		if (count >= 4)
+			index++;
+
+		//Convert index to an x and y offset ranging from -1 to 1 for a 3x3 grid.
+		int xOff = index % 3 - 1;
+		int yOff = index / 3 - 1;
+
+		//Check if offset tile is a corner, then set the bit if the shadow image is required.
+		bool isCorner = (abs(xOff) == 1 && abs(yOff) == 1);
+		bool isRequired = false;
+		if (isCorner)
+			isRequired = (isTileHigher(listTypeIDsAround[index], typeIDCenter) &&
+				isTileHigher(listTypeIDsAround[(xOff + 1) + 3], typeIDCenter) == false &&
+				isTileHigher(listTypeIDsAround[1 + (yOff + 1) * 3], typeIDCenter) == false);
+		else
+			isRequired = isTileHigher(listTypeIDsAround[index], typeIDCenter);
+
+		if (isRequired)
+			shadowMaskNew |= (1 << count);
 	}
 
-	return false;
+	return shadowMaskNew;
 }
 
 
 
-bool Tile::checkIfOkForPlant(bool growsOnWetDirt) {
-	if (typeID > -1 && typeID < listTileTypes.size()) {
-		if (listTileTypes[typeID].name == "water")
-			return false;
-		else if (listTileTypes[typeID].name == "dirt")
-			return (growsOnWetDirt ? isWet : false);
-		else if (listTileTypes[typeID].name.substr(0, 5) == "grass")
-			return (growsOnWetDirt ? false : true);
+bool Tile::setTypeID(int setTypeID) {
+	//Return whether or not the type changed.
+	if (setTypeID > -1 && setTypeID < typeCount && (TypeID)setTypeID != typeID) {
+		typeID = (TypeID)setTypeID;
+		return true;
 	}
 
 	return false;
@@ -178,28 +154,49 @@ bool Tile::checkIfOkForPlant(bool growsOnWetDirt) {
 
 
 
-bool Tile::checkIfOkForAnimal(int x, int y, Vector2D posCircle, float radiusCircle) {
-	if (typeID > -1 && typeID < listTileTypes.size()) {
-		//Check if the input circle overlaps this tile or not.
-		if (checkCircleOverlap(x, y, posCircle, radiusCircle)) {
-			//It does so check if the type is ok for animals.
-			if (listTileTypes[typeID].name == "water")
-				return false;
-			else if (listTileTypes[typeID].name == "dirt")
-				return true;
-			else if (listTileTypes[typeID].name.substr(0, 5) == "grass")
-				return true;
-		}
+bool Tile::addToWaterCount(int amount) {
+	return setWaterCount(waterCount + amount);
+}
+
+
+bool Tile::setWaterCount(int setWaterCount) {
+	//Return whether or not the tile changed between wet and dry.
+	bool isWetPrevious = checkIfWet();
+	waterCount = (Uint16)std::max(setWaterCount, 0);
 
+	return (checkIfWet() != isWetPrevious);
+}
+
+
+
+bool Tile::isTileHigher(TypeID typeIDOther, TypeID typeIDSelf) {
+	//Compare the heights.
+	return listTileTypes[(size_t)typeIDOther].height > listTileTypes[(size_t)typeIDSelf].height;
+}
+
+
+
+bool Tile::checkIfOkForPlant(bool growsOnWetDirt) const {
+	//Plants that grow on wet dirt also need the tile to actually be wet.
+	if (growsOnWetDirt)
+		return (listTileTypes[(size_t)typeID].flags & plantableWet) && checkIfWet();
+	else
+		return (listTileTypes[(size_t)typeID].flags & plantableDry) != 0;
+}
+
+
+
+bool Tile::checkIfOkForAnimal(int x, int y, Vector2D posCircle, float radiusCircle) const {
+	//Animals can be anywhere on a walkable tile, otherwise they can't overlap it.
+	if (listTileTypes[(size_t)typeID].flags & walkable)
 		return true;
-	}
 
-	return false;
+	return (checkCircleOverlap(x, y, posCircle, radiusCircle) == false);
 }
 
 
 
-bool Tile::checkCircleOverlap(int x, int y, Vector2D posCircle, float radiusCircle) {
+bool Tile::checkCircleOverlap(int x, int y, Vector2D posCircle, float radiusCircle) const {
 	//Define a rectangle for the edges of the tile.
 	float rectLeft = (float)(x);
 	float rectTop = (float)(y);
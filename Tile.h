@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <limits>
 #include "SDL2/SDL.h"
 #include "TextureLoader.h"
 #include "Vector2D.h"
@@ -8,37 +10,107 @@
 
 class Tile
 {
+public:
+	enum class TypeID : Uint8 {
+		water,
+		dirt,
+		grassPurple,
+		grassGreen,
+		grassYellow,
+		grassBlue,
+		grassWhite,
+		count
+	};
+
+
 private:
+	//The behaviour of each type is stored as bit flags so that checks don't need to compare names.
+	enum TypeFlag : Uint8 {
+		isWater = 1 << 0,
+		isDirt = 1 << 1,
+		isGrass = 1 << 2,
+		walkable = 1 << 3,
+		plantableDry = 1 << 4,
+		plantableWet = 1 << 5
+	};
+
 	struct Type {
-		std::string name = "";
-		int height = 0;
-		SDL_Color colorDark = {};
-		SDL_Color colorLight = {};
+		Uint8 flags;
+		Sint8 height;
+		SDL_Color colorDark;
+		SDL_Color colorLight;
 	};
 
+	static constexpr size_t typeCount = (size_t)TypeID::count;
+	static constexpr std::array<Type, typeCount> listTileTypes = { {
+		{ isWater, 0, SDL_Color{ 0, 67, 190 }, SDL_Color{ 0, 67, 190 } },
+		{ isDirt | walkable | plantableWet, 1, SDL_Color{ 138, 47, 50 }, SDL_Color{ 158, 56, 62 } },
+		{ isGrass | walkable | plantableDry, 2, SDL_Color{ 184, 33, 117 }, SDL_Color{ 218, 50, 143 } },
+		{ isGrass | walkable | plantableDry, 2, SDL_Color{ 11, 100, 100 }, SDL_Color{ 14, 131, 131 } },
+		{ isGrass | walkable | plantableDry, 2, SDL_Color{ 184, 176, 33 }, SDL_Color{ 218, 209, 50 } },
+		{ isGrass | walkable | plantableDry, 2, SDL_Color{ 33, 41, 184 }, SDL_Color{ 50, 59, 218 } },
+		{ isGrass | walkable | plantableDry, 2, SDL_Color{ 167, 167, 167 }, SDL_Color{ 199, 199, 199 } }
+	} };
+
+	static constexpr bool checkTypesValid();
+
 
 public:
-	Tile(SDL_Renderer* renderer);
-	void draw(SDL_Renderer* renderer, int x, int y, int tileSize);
-	void drawShadows(SDL_Renderer* renderer, int x, int y, int tileSize,
-		std::vector<Tile>& listTiles, int tileCountX, int tileCountY);
-	void setTypeID(int setTypeID);
-	static void refreshSurroundingIsWet(int x, int y,
-		std::vector<Tile>& listTiles, int tileCountX, int tileCountY);
-	bool checkIfOkForPlant(bool growsOnWetDirt);
-	bool checkIfOkForAnimal(int x, int y, Vector2D posCircle, float radiusCircle);
+	Tile();
+	static void loadShadowTextures(SDL_Renderer* renderer);
+	static void refreshShadowAtlas(SDL_Renderer* renderer);
+	void draw(SDL_Renderer* renderer, int x, int y, const SDL_Rect& rectScreen) const;
+	SDL_Color computeColor(int x, int y) const;
+	void drawShadows(SDL_Renderer* renderer, const SDL_Rect& rectScreen) const;
+	static Uint8 computeShadowMask(const TypeID (&listTypeIDsAround)[9]);
+	Uint8 getShadowMask() const { return shadowMask; }
+	void setShadowMask(Uint8 setShadowMask) { shadowMask = setShadowMask; }
+	bool setTypeID(int setTypeID);
+	TypeID getTypeID() const { return typeID; }
+	bool checkIfWater() const { return (listTileTypes[(size_t)typeID].flags & isWater) != 0; }
+	bool checkIfWet() const { return waterCount > 0; }
+	int getWaterCount() const { return waterCount; }
+	//The most water tiles that can be counted around a tile.
+	static const int waterCountMax = 0xFFFF;
+	bool addToWaterCount(int amount);
+	bool setWaterCount(int setWaterCount);
+	bool checkIfOkForPlant(bool growsOnWetDirt) const;
+	bool checkIfOkForAnimal(int x, int y, Vector2D posCircle, float radiusCircle) const;
 
 
 private:
-	bool isTileHigher(int x, int y,
-		std::vector<Tile>& listTiles, int tileCountX, int tileCountY);
-	bool checkCircleOverlap(int x, int y, Vector2D posCircle, float radiusCircle);
+	static bool isTileHigher(TypeID typeIDOther, TypeID typeIDSelf);
+	bool checkCircleOverlap(int x, int y, Vector2D posCircle, float radiusCircle) const;
+	static SDL_Rect computeShadowAtlasRect(int mask);
+
+
+	TypeID typeID;
+	//The number of water tiles close enough to make this tile wet.
+	Uint16 waterCount = 0;
+	static_assert(waterCountMax <= std::numeric_limits<Uint16>::max(), "waterCount can't hold waterCountMax.");
+	//One bit for each of listSpriteTileShadows that needs to be drawn on this tile.
+	Uint8 shadowMask = 0;
+
+	static std::vector<Sprite> listSpriteTileShadows;
+	//Every combination of listSpriteTileShadows composited together, indexed by shadowMask.
+	static SDL_Texture* textureShadowAtlas;
+	static int shadowAtlasCellSize;
+	static const int shadowAtlasColumns = 16;
+};
 
 
-	int typeID;
-	bool isWet = false;
 
-	static const std::vector<Type> listTileTypes;
+constexpr bool Tile::checkTypesValid() {
+	//Each type must be exactly one of water, dirt or grass, and water must never be walkable or
+	//plantable.
+	for (size_t count = 0; count < typeCount; count++) {
+		Uint8 flags = listTileTypes[count].flags;
+		int kinds = ((flags & isWater) ? 1 : 0) + ((flags & isDirt) ? 1 : 0) + ((flags & isGrass) ? 1 : 0);
+		if (kinds != 1)
+			return false;
+		if ((flags & isWater) && (flags & (walkable | plantableDry | plantableWet)))
+			return false;
+	}
 
-	static std::vector<SDL_Texture*> listTextureTileShadows;
-};
\ No newline at end of file
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "World.h"
+#include <algorithm>
+
+
+
+World::World(int setTileCountX, int setTileCountY) :
+	level(setTileCountX, setTileCountY) {
+
+}
+
+
+
+void World::step(float dT) {
+	refreshAfterChanges();
+
+	//Update the plants.
+	Plant::updateAll(plants, dT);
+
+	//Update the animals, and keep the grid in sync with any that moved.
+	for (int count = 0; count < animals.size(); count++) {
+		Animal::update(animals, count, dT, *this);
+		gridAnimals.move(animals.slots.getSlot(count), animals.listPosPrevious[count],
+			animals.listPos[count]);
+	}
+}
+
+
+
+int World::advance(float timeS) {
+	//Run as many fixed length ticks as fit in the elapsed time so that the results don't depend
+	//on the frame rate.  Return the number of ticks that were run.
+	refreshAfterChanges();
+
+	timeSAccumulated += timeS;
+
+	int tickCount = 0;
+	while (timeSAccumulated >= tickDT && tickCount < tickCountMaxPerAdvance) {
+		step(tickDT);
+		timeSAccumulated -= tickDT;
+		tickCount++;
+	}
+
+	//If it fell too far behind then drop the rest instead of trying to catch up forever.
+	if (timeSAccumulated >= tickDT)
+		timeSAccumulated = fmod(timeSAccumulated, tickDT);
+
+	return tickCount;
+}
+
+
+void World::setTickRate(int ticksPerSecond) {
+	if (ticksPerSecond > 0) {
+		tickDT = 1.0f / ticksPerSecond;
+		timeSAccumulated = 0.0f;
+	}
+}
+
+
+
+const std::vector<int>& World::queryPlants(Vector2D pos, float radius) {
+	//Return the indices of the plants that could overlap the input circle.
+	return convertSlotsToIndices(gridPlants.query(pos, radius), plants.slots);
+}
+
+
+const std::vector<int>& World::queryAnimals(Vector2D pos, float radius) {
+	return convertSlotsToIndices(gridAnimals.query(pos, radius), animals.slots);
+}
+
+
+const std::vector<int>& World::queryPlantsInRect(Vector2D posMin, Vector2D posMax) {
+	return convertSlotsToIndices(gridPlants.queryRect(posMin, posMax), plants.slots);
+}
+
+
+const std::vector<int>& World::queryAnimalsInRect(Vector2D posMin, Vector2D posMax) {
+	return convertSlotsToIndices(gridAnimals.queryRect(posMin, posMax), animals.slots);
+}
+
+
+const std::vector<int>& World::convertSlotsToIndices(const std::vector<int>& listSlots,
+	SlotMap& slots) {
+	listIndicesFound.clear();
+	for (int slot : listSlots)
+		listIndicesFound.push_back(slots.getIndexForSlot(slot));
+
+	return listIndicesFound;
+}
+
+
+
+void World::setTileTypeIDSelected(int tileTypeID) {
+	level.setTileTypeIDSelected(tileTypeID);
+}
+
+
+void World::placeTileTypeIDSelected(int x, int y) {
+	//The level marks the tiles whose type or wetness actually changed, and the entities on them
+	//are checked once for all of the changes made before the next refreshAfterChanges.  The same
+	//goes for the bulk edits below, however many tiles they change.
+	level.placeTileTypeIDSelected(x, y);
+}
+
+
+void World::fillRectWithTileTypeIDSelected(SDL_Rect rectTiles) {
+	level.fillRectWithTileTypeIDSelected(rectTiles);
+}
+
+
+void World::paintCircleWithTileTypeIDSelected(Vector2D posCenter, float radius) {
+	level.paintCircleWithTileTypeIDSelected(posCenter, radius);
+}
+
+
+void World::paintLineWithTileTypeIDSelected(Vector2D posStart, Vector2D posEnd, float radius) {
+	level.paintLineWithTileTypeIDSelected(posStart, posEnd, radius);
+}
+
+
+bool World::floodFillWithTileTypeIDSelected(int x, int y) {
+	return level.floodFillWithTileTypeIDSelected(x, y);
+}
+
+
+void World::setWetDistance(int wetDistance) {
+	level.setWetDistance(wetDistance);
+}
+
+
+
+EntityHandle World::addPlant(int plantTypeID, Vector2D pos) {
+	//Return the new plant's handle, or an invalid handle if it couldn't be placed there.
+	if (Plant::checkIfPositionOkForType(pos, plantTypeID, *this)) {
+		int index = Plant::add(plants, plantTypeID, pos);
+		int slot = plants.slots.getSlot(index);
+		gridPlants.insert(slot, plants.listPos[index], Plant::computeRadiusBounding(plantTypeID));
+		level.setPlantIDForTiles(Plant::computeRectTiles(plants, index), slot);
+		return plants.slots.getHandle(index);
+	}
+
+	return EntityHandle();
+}
+
+
+int World::getPlantIndex(EntityHandle handle) {
+	//Return -1 once the plant has been removed, even if it's still waiting to be erased.
+	int index = plants.slots.getIndex(handle);
+	if (index != -1 && plants.slots.checkIfEraseQueued(index))
+		return -1;
+
+	return index;
+}
+
+
+bool World::removePlant(EntityHandle handle) {
+	int index = getPlantIndex(handle);
+	if (index == -1)
+		return false;
+
+	erasePlant(index);
+	return true;
+}
+
+
+void World::removePlantsAtPosition(Vector2D pos) {
+	//Look up the plant that covers the tile at the input position.
+	int slot = level.getPlantIDForTile((int)pos.x, (int)pos.y);
+	if (slot != -1 && pos.x >= 0.0f && pos.y >= 0.0f)
+		removePlant(plants.slots.getHandle(plants.slots.getIndexForSlot(slot)));
+}
+
+
+void World::erasePlant(int index) {
+	//Take the plant out of the level and the grid straight away, but leave it in the store until
+	//the next eraseQueued so that the indices held by the caller stay valid.
+	if (plants.slots.checkIfEraseQueued(index) == false) {
+		int slot = plants.slots.getSlot(index);
+		level.setPlantIDForTiles(Plant::computeRectTiles(plants, index), -1);
+		gridPlants.remove(slot, plants.listPos[index]);
+		plants.queueErase(index);
+	}
+}
+
+
+void World::erasePlants(std::vector<int>& listPlantIDs) {
+	for (int index : listPlantIDs)
+		erasePlant(index);
+}
+
+
+
+EntityHandle World::addAnimal(int animalTypeID, Vector2D pos, float angle) {
+	//Return the new animal's handle, or an invalid handle if it couldn't be placed there.
+	if (Animal::checkIfPositionOkForType(pos, animalTypeID, *this)) {
+		int index = Animal::add(animals, animalTypeID, pos, angle);
+		gridAnimals.insert(animals.slots.getSlot(index), animals.listPos[index],
+			Animal::computeRadius(animalTypeID));
+		return animals.slots.getHandle(index);
+	}
+
+	return EntityHandle();
+}
+
+
+int World::getAnimalIndex(EntityHandle handle) {
+	//Return -1 once the animal has been removed, even if it's still waiting to be erased.
+	int index = animals.slots.getIndex(handle);
+	if (index != -1 && animals.slots.checkIfEraseQueued(index))
+		return -1;
+
+	return index;
+}
+
+
+bool World::removeAnimal(EntityHandle handle) {
+	int index = getAnimalIndex(handle);
+	if (index == -1)
+		return false;
+
+	eraseAnimal(index);
+	return true;
+}
+
+
+void World::removeAnimalsAtPosition(Vector2D pos) {
+	//Find every animal under the position, then remove them by handle.
+	listHandlesToRemove.clear();
+	for (int slot : gridAnimals.query(pos, 0.0f)) {
+		int index = animals.slots.getIndexForSlot(slot);
+		if (Animal::checkCircleOverlap(animals, index, pos, 0.0f))
+			listHandlesToRemove.push_back(animals.slots.getHandle(index));
+	}
+
+	for (auto& handleSelected : listHandlesToRemove)
+		removeAnimal(handleSelected);
+}
+
+
+void World::eraseAnimal(int index) {
+	//Take the animal out of the grid straight away but leave it in the store until the next
+	//eraseQueued.
+	if (animals.slots.checkIfEraseQueued(index) == false) {
+		gridAnimals.remove(animals.slots.getSlot(index), animals.listPos[index]);
+		animals.queueErase(index);
+	}
+}
+
+
+void World::eraseAnimals(std::vector<int>& listAnimalIDs) {
+	for (int index : listAnimalIDs)
+		eraseAnimal(index);
+}
+
+
+void World::refreshAfterChanges() {
+	removeEntitiesIfTilesChanged();
+	eraseQueued();
+}
+
+
+void World::removeEntitiesIfTilesChanged() {
+	//Only the plants and animals that overlap a tile that changed since the last call can have
+	//become invalid.
+	listTileIndicesChanged.clear();
+	level.takeTilesDirty(Level::dirtyEntities, listTileIndicesChanged);
+	if (listTileIndicesChanged.empty())
+		return;
+
+	//Find the plants covering the changed tiles and the animals near them.  Each entity is
+	//only checked once even if it overlaps several of the tiles.
+	int tileCountX = level.getTileCountX();
+	listIDsToCheck.clear();
+	for (int index : listTileIndicesChanged) {
+		int slot = level.getPlantIDForTile(index % tileCountX, index / tileCountX);
+		if (slot != -1)
+			listIDsToCheck.push_back(plants.slots.getIndexForSlot(slot));
+	}
+	sortAndRemoveDuplicates(listIDsToCheck);
+
+	listIDsToErase.clear();
+	for (int index : listIDsToCheck)
+		if (Plant::checkIfTilesUnderOk(plants, index, level) == false)
+			listIDsToErase.push_back(index);
+	erasePlants(listIDsToErase);
+
+	//An animal can overlap a tile if it's center is within this distance of the tile's center.
+	const float distanceTileCorner = 0.7072f;
+	listIDsToCheck.clear();
+	for (int index : listTileIndicesChanged) {
+		Vector2D posTile(index % tileCountX + 0.5f, index / tileCountX + 0.5f);
+		for (int animalIndex : queryAnimals(posTile, distanceTileCorner))
+			listIDsToCheck.push_back(animalIndex);
+	}
+	sortAndRemoveDuplicates(listIDsToCheck);
+
+	listIDsToErase.clear();
+	for (int index : listIDsToCheck)
+		if (Animal::checkIfTilesUnderOk(animals, index, level) == false)
+			listIDsToErase.push_back(index);
+	eraseAnimals(listIDsToErase);
+}
+
+
+void World::sortAndRemoveDuplicates(std::vector<int>& listIDs) {
+	std::sort(listIDs.begin(), listIDs.end());
+	listIDs.erase(std::unique(listIDs.begin(), listIDs.end()), listIDs.end());
+}
+
+
+void World::eraseQueued() {
+	//Compact the stores once for every erase since the last call.  Each erase only moves the last
+	//entity into the hole, and the grid and level refer to entities by slot so they're unaffected.
+	plants.eraseQueued();
+	animals.eraseQueued();
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include "Vector2D.h"
+#include "SpatialHashGrid.h"
+#include "Level.h"
+#include "Plant.h"
+#include "Animal.h"
+
+
+
+//The simulation side of the game.  It owns the level, plants and animals and can be stepped
+//without a window or renderer, e.g. for soak tests on headless machines.
+class World
+{
+public:
+	World(int setTileCountX, int setTileCountY);
+	void step(float dT);
+	int advance(float timeS);
+	void setTickRate(int ticksPerSecond);
+	float getTickDT() { return tickDT; }
+	float getInterpolationAlpha() { return timeSAccumulated / tickDT; }
+
+	Level& getLevel() { return level; }
+	PlantStore& getPlants() { return plants; }
+	AnimalStore& getAnimals() { return animals; }
+	const std::vector<int>& queryPlants(Vector2D pos, float radius);
+	const std::vector<int>& queryAnimals(Vector2D pos, float radius);
+	const std::vector<int>& queryPlantsInRect(Vector2D posMin, Vector2D posMax);
+	const std::vector<int>& queryAnimalsInRect(Vector2D posMin, Vector2D posMax);
+
+	void setTileTypeIDSelected(int tileTypeID);
+	void placeTileTypeIDSelected(int x, int y);
+	void fillRectWithTileTypeIDSelected(SDL_Rect rectTiles);
+	void paintCircleWithTileTypeIDSelected(Vector2D posCenter, float radius);
+	void paintLineWithTileTypeIDSelected(Vector2D posStart, Vector2D posEnd, float radius);
+	bool floodFillWithTileTypeIDSelected(int x, int y);
+	void setWetDistance(int wetDistance);
+
+	//Entities are added and removed by handle, which stays valid while other entities are erased
+	//and stops resolving once it's own entity is removed.
+	EntityHandle addPlant(int plantTypeID, Vector2D pos);
+	int getPlantIndex(EntityHandle handle);
+	bool removePlant(EntityHandle handle);
+	void removePlantsAtPosition(Vector2D pos);
+
+	EntityHandle addAnimal(int animalTypeID, Vector2D pos, float angle);
+	int getAnimalIndex(EntityHandle handle);
+	bool removeAnimal(EntityHandle handle);
+	void removeAnimalsAtPosition(Vector2D pos);
+
+
+private:
+	void refreshAfterChanges();
+	void removeEntitiesIfTilesChanged();
+	static void sortAndRemoveDuplicates(std::vector<int>& listIDs);
+	void erasePlant(int index);
+	void erasePlants(std::vector<int>& listPlantIDs);
+	void eraseAnimal(int index);
+	void eraseAnimals(std::vector<int>& listAnimalIDs);
+	void eraseQueued();
+	const std::vector<int>& convertSlotsToIndices(const std::vector<int>& listSlots, SlotMap& slots);
+
+
+	Level level;
+
+	//The simulation always steps by tickDT, and any time left over is carried to the next advance.
+	float tickDT = 1.0f / 60.0f;
+	float timeSAccumulated = 0.0f;
+	const int tickCountMaxPerAdvance = 10;
+
+	PlantStore plants;
+	AnimalStore animals;
+
+	//Plants and animals are bucketed by their slot in the stores above, which is also the id
+	//stored in the level's plant occupancy layer.
+	SpatialHashGrid gridPlants, gridAnimals;
+	std::vector<int> listIDsToCheck, listIDsToErase, listIndicesFound, listTileIndicesChanged;
+	std::vector<EntityHandle> listHandlesToRemove;
+};
\ No newline at end of file
@@ -1,17 +1,82 @@
 #include <iostream>
+#include <chrono>
+#include <cstring>
 #include "SDL2/SDL.h"
 #include "Game.h"
+#include "World.h"
 
 
 bool fullscreen = true;
 
 
 
+int runHeadless(int tickCount, int tickRate) {
+	//Step a populated world as fast as possible without creating a window or renderer.
+	const int tileCountX = 60, tileCountY = 34;
+	World world(tileCountX, tileCountY);
+	world.setTickRate(tickRate);
+	const float dT = world.getTickDT();
+
+	//Dig a pond in the middle so that there are wet tiles around it.
+	world.setTileTypeIDSelected((int)Tile::TypeID::water);
+	world.paintCircleWithTileTypeIDSelected(Vector2D(tileCountX / 2.0f, tileCountY / 2.0f), 3.0f);
+
+	//Scatter plants that grow on grass and animals around the level.
+	for (int count = 0; count < tileCountX * tileCountY / 4; count++) {
+		Vector2D pos(MathAddon::randFloat() * tileCountX, MathAddon::randFloat() * tileCountY);
+		if (count % 2 == 0)
+			world.addPlant(2 + rand() % 3, Vector2D((int)pos.x + 0.5f, (int)pos.y + 0.5f));
+		else
+			world.addAnimal(rand() % 3, pos, MathAddon::randAngleRad());
+	}
+
+	auto timeStart = std::chrono::steady_clock::now();
+	for (int count = 0; count < tickCount; count++)
+		world.step(dT);
+	std::chrono::duration<double> timeElapsed = std::chrono::steady_clock::now() - timeStart;
+
+	std::cout << "Stepped " << tickCount << " ticks with " << world.getPlants().size() <<
+		" plants and " << world.getAnimals().size() << " animals in " <<
+		timeElapsed.count() << " s" << std::endl;
+
+	//Only the chunks that something changed in are allocated.
+	Level& level = world.getLevel();
+	std::cout << "Level has " << level.countChunksAllocated() << " of " <<
+		level.getChunkCountX() * level.getChunkCountY() << " chunks allocated and " <<
+		level.countWetTilesInRect(SDL_Rect{ 0, 0, tileCountX, tileCountY }) << " wet tiles" << std::endl;
+	return 0;
+}
+
+
+
 int main(int argc, char* args[]) {
 	//Seed the random number generator with the current time so that it will generate different 
 	//numbers every time the game is run.
 	srand((unsigned)time(NULL));
 
+	//The simulation steps at a fixed number of ticks per second no matter the frame rate, e.g.
+	//"-tickRate 120".  Zero keeps the world's default.
+	int tickRate = 0;
+	for (int count = 1; count + 1 < argc; count++)
+		if (strcmp(args[count], "-tickRate") == 0)
+			tickRate = atoi(args[count + 1]);
+
+	//Run the simulation without a window if requested, e.g. "-headless 3600".
+	if (argc > 1 && strcmp(args[1], "-headless") == 0)
+		return runHeadless((argc > 2 && args[2][0] != '-') ? atoi(args[2]) : 3600, tickRate);
+
+	//Pack the images into a single file for faster loading, e.g. "-buildPack Data/Assets.pack".
+	if (argc > 1 && strcmp(args[1], "-buildPack") == 0) {
+		std::string filepathPack = (argc > 2 ? args[2] : "Data/Assets.pack");
+		if (TextureLoader::buildAssetPack(filepathPack, "Manifest.txt")) {
+			std::cout << "Built " << filepathPack << std::endl;
+			return 0;
+		}
+
+		std::cout << "Error: Couldn't build " << filepathPack << std::endl;
+		return 1;
+	}
+
 	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
 		std::cout << "Error: Couldn't initialize SDL Video = " << SDL_GetError() << std::endl;
 		return 1;
@@ -50,12 +115,28 @@ int main(int argc, char* args[]) {
 				SDL_GetRendererInfo(renderer, &rendererInfo);
 				std::cout << "Renderer = " << rendererInfo.name << std::endl;
 
+				//Pre-rotate the animals when rendering in software, where rotating them as they're
+				//drawn is slow.  "-rotations 64" sets the number of angles, and 0 turns it off.
+				int rotationAngleCount = ((rendererInfo.flags & SDL_RENDERER_SOFTWARE) ? 64 : 0);
+				for (int count = 1; count + 1 < argc; count++)
+					if (strcmp(args[count], "-rotations") == 0)
+						rotationAngleCount = atoi(args[count + 1]);
+				Animal::setRotatedSpriteAngleCount(rotationAngleCount);
+
+				//The plants are pre-scaled to this many frames of their bobbing animation, e.g.
+				//"-plantFrames 8", and 0 scales them as they're drawn.
+				for (int count = 1; count + 1 < argc; count++)
+					if (strcmp(args[count], "-plantFrames") == 0)
+						Plant::setScaledSpriteFrameCount(atoi(args[count + 1]));
+
 				//Get the dimensions of the window.
 				int windowWidth = 0, windowHeight = 0;
 				SDL_GetWindowSize(window, &windowWidth, &windowHeight);
 
 				//Start the game.
 				Game game(window, renderer, windowWidth, windowHeight);
+				game.setTickRate(tickRate);
+				game.run();
 
 				//Clean up.
 				SDL_DestroyRenderer(renderer);